@@ -2,6 +2,7 @@
 #include "Application.h"
 
 #include "ImGui/ImGuiLayer.h"
+#include "JobSystem.h"
 
 #include "AssetManager/AssetRegistry.h"
 
@@ -16,6 +17,8 @@ namespace Echo
 		AssetRegistry::SetGlobalPath(resourcePath);
 		s_Instance = this;
 
+		JobSystem::Init();
+
 		WindowProps props{};
 		props.Width = width;
 		props.Height = height;
@@ -37,6 +40,8 @@ namespace Echo
 		m_AssetWatcher = new AssetWatcher();
 		s_Instance = this;
 
+		JobSystem::Init();
+
 		WindowProps props{};
 		props.Width = -1;
 		props.Height = -1;
@@ -79,6 +84,8 @@ namespace Echo
 
 		for (Layer* layer : m_LayerStack)
 			layer->OnDetach();
+
+		JobSystem::Shutdown();
 	}
 
 	void Application::OnEvent(Event& e)
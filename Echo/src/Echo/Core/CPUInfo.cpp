@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "CPUInfo.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define EC_X86_64 1
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace Echo
+{
+
+#ifdef EC_X86_64
+	static void CPUID(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+	{
+	#ifdef _MSC_VER
+		__cpuidex((int*)registers, (int)leaf, (int)subleaf);
+	#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+	#endif
+	}
+
+	static uint64_t ReadXCR0()
+	{
+	#ifdef _MSC_VER
+		return _xgetbv(0);
+	#else
+		uint32_t eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64_t)edx << 32) | eax;
+	#endif
+	}
+
+	static SIMDLevel DetectSIMDLevel()
+	{
+		// SSE2 is part of x86-64
+		uint32_t registers[4];
+		CPUID(0, 0, registers);
+		uint32_t maxLeaf = registers[0];
+
+		CPUID(1, 0, registers);
+		bool fma = (registers[2] & (1u << 12)) != 0;
+		bool osxsave = (registers[2] & (1u << 27)) != 0;
+		bool avx = (registers[2] & (1u << 28)) != 0;
+		if (!fma || !osxsave || !avx || maxLeaf < 7)
+			return SIMDLevel::SSE2;
+
+		// XMM and YMM state must both be enabled by the OS
+		if ((ReadXCR0() & 0x6) != 0x6)
+			return SIMDLevel::SSE2;
+
+		CPUID(7, 0, registers);
+		bool avx2 = (registers[1] & (1u << 5)) != 0;
+		return avx2 ? SIMDLevel::AVX2 : SIMDLevel::SSE2;
+	}
+#else
+	static SIMDLevel DetectSIMDLevel()
+	{
+		return SIMDLevel::Scalar;
+	}
+#endif
+
+	SIMDLevel CPUInfo::GetSIMDLevel()
+	{
+		static SIMDLevel s_Level = DetectSIMDLevel();
+		return s_Level;
+	}
+
+	const char* CPUInfo::SIMDLevelToString(SIMDLevel level)
+	{
+		switch (level)
+		{
+			case SIMDLevel::Scalar: return "Scalar";
+			case SIMDLevel::SSE2: return "SSE2";
+			case SIMDLevel::AVX2: return "AVX2";
+		}
+		return "Unknown";
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Echo
+{
+
+	// Highest vector instruction set the CPU and OS both support, in increasing order
+	enum class SIMDLevel : uint8_t
+	{
+		Scalar = 0,
+		SSE2,
+		AVX2
+	};
+
+	class CPUInfo
+	{
+	public:
+		// Detected once, AVX2 also requires FMA and the OS saving YMM state
+		static SIMDLevel GetSIMDLevel();
+
+		static const char* SIMDLevelToString(SIMDLevel level);
+	};
+
+}
\ No newline at end of file
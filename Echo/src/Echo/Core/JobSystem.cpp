@@ -0,0 +1,460 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+namespace Echo
+{
+
+	struct Job
+	{
+		JobFunction Function;
+		JobCounter* Counter = nullptr;
+		const JobCounter* Dependency = nullptr;
+	};
+
+	// The owning thread pushes and pops at the back (LIFO, cache friendly),
+	// other threads steal the oldest work from the front.
+	class WorkStealingQueue
+	{
+	public:
+		void Push(Job&& job)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(std::move(job));
+		}
+
+		bool Pop(Job& outJob)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Jobs.empty())
+				return false;
+
+			outJob = std::move(m_Jobs.back());
+			m_Jobs.pop_back();
+			return true;
+		}
+
+		bool Steal(Job& outJob)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Jobs.empty())
+				return false;
+
+			outJob = std::move(m_Jobs.front());
+			m_Jobs.pop_front();
+			return true;
+		}
+	private:
+		std::mutex m_Mutex;
+		std::deque<Job> m_Jobs;
+	};
+
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+		// Index 0 belongs to the main thread, 1..N to the workers
+		std::vector<Scope<WorkStealingQueue>> Queues;
+
+		std::atomic<bool> Running = false;
+		std::atomic<uint32_t> PendingJobs = 0;
+		std::atomic<uint32_t> NextExternalQueue = 0;
+
+		// Jobs whose dependency hadn't finished when they were scheduled, queued by whichever thread
+		// brings that counter to zero
+		std::mutex WaitingMutex;
+		std::unordered_map<const JobCounter*, std::vector<Job>> WaitingJobs;
+		std::atomic<uint32_t> WaitingJobCount = 0;
+
+		std::mutex WakeMutex;
+		std::condition_variable WakeCondition;
+
+		bool Initialized = false;
+	};
+
+	static JobSystemData s_Data;
+	static thread_local uint32_t s_ThreadIndex = UINT32_MAX;
+
+	static void PushJob(Job&& job)
+	{
+		uint32_t queueIndex = s_ThreadIndex;
+		if (queueIndex >= s_Data.Queues.size())
+		{
+			queueIndex = s_Data.NextExternalQueue.fetch_add(1, std::memory_order_relaxed) % (uint32_t)s_Data.Queues.size();
+		}
+
+		s_Data.PendingJobs.fetch_add(1, std::memory_order_relaxed);
+		s_Data.Queues[queueIndex]->Push(std::move(job));
+
+		{
+			// Taking the lock avoids missing a worker that is about to go to sleep
+			std::lock_guard<std::mutex> lock(s_Data.WakeMutex);
+		}
+		s_Data.WakeCondition.notify_one();
+	}
+
+	static void SignalCounter(JobCounter& counter)
+	{
+		uint32_t value = counter.Value.load(std::memory_order_relaxed);
+		while (value > 1)
+		{
+			if (counter.Value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				return;
+		}
+
+		// Possibly the last signal. It's made under the lock jobs are parked with, so nothing gets parked on the
+		// counter once it reads zero. A waiter may destroy the counter as soon as it does, after the decrement
+		// only its address is used
+		std::vector<Job> ready;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.WaitingMutex);
+			uint32_t previous = counter.Value.fetch_sub(1, std::memory_order_acq_rel);
+			EC_CORE_ASSERT(previous != 0, "Job counter signaled more often than it was incremented!");
+			if (previous != 1)
+				return;
+
+			auto it = s_Data.WaitingJobs.find(&counter);
+			if (it == s_Data.WaitingJobs.end())
+				return;
+
+			ready = std::move(it->second);
+			s_Data.WaitingJobs.erase(it);
+			s_Data.WaitingJobCount.fetch_sub((uint32_t)ready.size(), std::memory_order_relaxed);
+		}
+
+		for (Job& job : ready)
+		{
+			PushJob(std::move(job));
+		}
+	}
+
+	static bool TryRunJob(uint32_t threadIndex)
+	{
+		uint32_t queueCount = (uint32_t)s_Data.Queues.size();
+		if (queueCount == 0)
+			return false;
+
+		uint32_t home = threadIndex < queueCount ? threadIndex : 0;
+
+		Job job;
+		bool found = s_Data.Queues[home]->Pop(job);
+		for (uint32_t i = 1; !found && i < queueCount; i++)
+		{
+			found = s_Data.Queues[(home + i) % queueCount]->Steal(job);
+		}
+
+		if (!found)
+			return false;
+
+		s_Data.PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+		job.Function();
+
+		if (job.Counter)
+		{
+			SignalCounter(*job.Counter);
+		}
+		return true;
+	}
+
+	static void WorkerLoop(uint32_t threadIndex)
+	{
+		s_ThreadIndex = threadIndex;
+
+		while (s_Data.Running.load(std::memory_order_acquire))
+		{
+			if (TryRunJob(threadIndex))
+				continue;
+
+			if (s_Data.PendingJobs.load(std::memory_order_relaxed) > 0)
+			{
+				// Work exists but is being taken by someone else
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_Data.WakeMutex);
+			s_Data.WakeCondition.wait(lock, []()
+			{
+				return !s_Data.Running.load(std::memory_order_acquire) || s_Data.PendingJobs.load(std::memory_order_relaxed) > 0;
+			});
+		}
+	}
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		EC_PROFILE_FUNCTION();
+		EC_CORE_ASSERT(!s_Data.Initialized, "JobSystem already initialized!");
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		s_Data.Queues.clear();
+		for (uint32_t i = 0; i < workerCount + 1; i++)
+		{
+			s_Data.Queues.push_back(CreateScope<WorkStealingQueue>());
+		}
+
+		s_ThreadIndex = 0;
+		s_Data.Running = true;
+		s_Data.Initialized = true;
+
+		for (uint32_t i = 1; i <= workerCount; i++)
+		{
+			s_Data.Workers.emplace_back(WorkerLoop, i);
+		}
+
+		EC_CORE_INFO("JobSystem started with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		EC_PROFILE_FUNCTION();
+		if (!s_Data.Initialized)
+			return;
+
+		// Finish whatever is still queued before stopping the workers
+		while (s_Data.PendingJobs.load(std::memory_order_acquire) > 0)
+		{
+			if (!TryRunJob(0))
+				std::this_thread::yield();
+		}
+		EC_CORE_ASSERT(s_Data.WaitingJobCount.load() == 0, "Jobs are still waiting on dependencies that never finished!");
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.WakeMutex);
+			s_Data.Running = false;
+		}
+		s_Data.WakeCondition.notify_all();
+
+		for (std::thread& worker : s_Data.Workers)
+		{
+			worker.join();
+		}
+
+		s_Data.Workers.clear();
+		s_Data.Queues.clear();
+		s_Data.Initialized = false;
+	}
+
+	void JobSystem::Execute(JobFunction job, JobCounter* counter, const JobCounter* dependency)
+	{
+		if (!s_Data.Initialized)
+		{
+			// Without workers everything runs inline on the caller
+			EC_CORE_ASSERT(!dependency || dependency->IsDone(), "Job dependency can never complete without a JobSystem!");
+			job();
+			return;
+		}
+
+		if (counter)
+		{
+			counter->Value.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (!dependency || dependency->IsDone())
+		{
+			PushJob({ std::move(job), counter, dependency });
+			return;
+		}
+
+		// Park the job on its dependency instead of queueing it, nothing polls it until the counter reaches zero.
+		// The last signal takes the same lock, checked under it the dependency can't finish without seeing the job
+		{
+			std::lock_guard<std::mutex> lock(s_Data.WaitingMutex);
+			if (!dependency->IsDone())
+			{
+				s_Data.WaitingJobs[dependency].push_back({ std::move(job), counter, dependency });
+				s_Data.WaitingJobCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+		PushJob({ std::move(job), counter, dependency });
+	}
+
+	void JobSystem::Signal(JobCounter& counter)
+	{
+		if (!s_Data.Initialized)
+		{
+			counter.Value.fetch_sub(1, std::memory_order_acq_rel);
+			return;
+		}
+
+		SignalCounter(counter);
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function, JobCounter& counter)
+	{
+		if (count == 0)
+			return;
+
+		grainSize = std::max(grainSize, 1u);
+
+		// Jobs may outlive the caller's function object
+		Ref<ParallelForFunction> sharedFunction = CreateRef<ParallelForFunction>(function);
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			uint32_t end = std::min(begin + grainSize, count);
+			Execute([sharedFunction, begin, end]() { (*sharedFunction)(begin, end); }, &counter);
+		}
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function)
+	{
+		EC_PROFILE_FUNCTION();
+		if (count == 0)
+			return;
+
+		grainSize = std::max(grainSize, 1u);
+		if (!s_Data.Initialized || count <= grainSize)
+		{
+			function(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			uint32_t end = std::min(begin + grainSize, count);
+			Execute([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+		Wait(counter);
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		EC_PROFILE_FUNCTION();
+		while (!counter.IsDone())
+		{
+			if (!TryRunJob(s_ThreadIndex))
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return s_Data.Initialized ? (uint32_t)s_Data.Queues.size() : 1;
+	}
+
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		return s_ThreadIndex;
+	}
+
+	bool JobSystem::IsInitialized()
+	{
+		return s_Data.Initialized;
+	}
+
+	JobBenchmarkResult JobSystem::Benchmark(uint32_t jobCount)
+	{
+		EC_PROFILE_FUNCTION();
+		constexpr uint32_t chainLength = 64;
+		constexpr uint32_t producersPerGate = 4;
+		uint32_t chainCount = std::max(jobCount / chainLength, 1u);
+		uint32_t gateCount = std::max(jobCount / (producersPerGate + 1), 1u);
+
+		JobBenchmarkResult result;
+		result.JobCount = jobCount;
+
+		std::atomic<uint64_t> sum = 0;
+		// One counter per link, each only ever holds the single job of its link
+		std::vector<JobCounter> links(chainCount * chainLength);
+		std::vector<std::atomic<uint32_t>> progress(chainCount);
+		std::atomic<uint32_t> outOfOrder = 0;
+
+		// Set by hand and lowered through Signal by producer jobs, like the scheduler's per system counters
+		std::vector<JobCounter> gates(gateCount);
+		std::vector<std::atomic<uint32_t>> produced(gateCount);
+		std::atomic<uint32_t> consumed = 0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		JobCounter counter;
+		for (uint32_t i = 0; i < jobCount; i++)
+		{
+			Execute([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+		}
+		Wait(counter);
+
+		// Chains are scheduled link by link across all chains, so most links get parked on their dependency
+		for (uint32_t link = 0; link < chainLength; link++)
+		{
+			for (uint32_t chain = 0; chain < chainCount; chain++)
+			{
+				JobCounter* current = &links[chain * chainLength + link];
+				const JobCounter* previous = link > 0 ? current - 1 : nullptr;
+				Execute([&progress, &outOfOrder, chain, link]()
+				{
+					if (progress[chain].load(std::memory_order_acquire) != link)
+						outOfOrder.fetch_add(1, std::memory_order_relaxed);
+					progress[chain].store(link + 1, std::memory_order_release);
+				}, current, previous);
+			}
+		}
+		for (uint32_t chain = 0; chain < chainCount; chain++)
+		{
+			Wait(links[chain * chainLength + chainLength - 1]);
+		}
+
+		// Consumers are scheduled before their producers so they get parked. The last gate is signaled from
+		// this thread instead of a job
+		JobCounter gated;
+		for (uint32_t gate = 0; gate < gateCount; gate++)
+		{
+			gates[gate].Value.store(producersPerGate, std::memory_order_relaxed);
+			Execute([&produced, &consumed, &outOfOrder, gate]()
+			{
+				if (produced[gate].load(std::memory_order_acquire) != producersPerGate)
+					outOfOrder.fetch_add(1, std::memory_order_relaxed);
+				consumed.fetch_add(1, std::memory_order_relaxed);
+			}, &gated, &gates[gate]);
+		}
+		for (uint32_t gate = 0; gate < gateCount; gate++)
+		{
+			for (uint32_t producer = 0; producer < producersPerGate; producer++)
+			{
+				auto produce = [&gates, &produced, gate]()
+				{
+					produced[gate].fetch_add(1, std::memory_order_release);
+					Signal(gates[gate]);
+				};
+
+				if (gate == gateCount - 1 && producer == producersPerGate - 1)
+					produce();
+				else
+					Execute(produce, &gated);
+			}
+		}
+		Wait(gated);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		result.Milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+		if (sum.load() != (uint64_t)jobCount * (jobCount - 1) / 2)
+			result.Failures++;
+
+		result.Failures += outOfOrder.load();
+		result.Failures += gateCount - consumed.load();
+		for (uint32_t chain = 0; chain < chainCount; chain++)
+		{
+			if (progress[chain].load() != chainLength)
+				result.Failures++;
+		}
+
+		if (result.Passed())
+			EC_CORE_INFO("JobSystem benchmark passed: {0} jobs in {1:.2f} ms", jobCount, result.Milliseconds);
+		else
+			EC_CORE_ERROR("JobSystem benchmark failed: {0} jobs lost, out of order or never run", result.Failures);
+		return result;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+namespace Echo
+{
+
+	// Tracks a group of jobs. Incremented when a job is scheduled against it and
+	// decremented when that job finishes.
+	struct JobCounter
+	{
+		std::atomic<uint32_t> Value{ 0 };
+
+		bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+	};
+
+	// Outcome of JobSystem::Benchmark
+	struct JobBenchmarkResult
+	{
+		uint32_t JobCount = 0;
+		// Jobs that were lost, started before their dependency finished or never ran
+		uint32_t Failures = 0;
+		double Milliseconds = 0.0;
+
+		bool Passed() const { return JobCount != 0 && Failures == 0; }
+	};
+
+	using JobFunction = std::function<void()>;
+	using ParallelForFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+	class JobSystem
+	{
+	public:
+		// workerCount == 0 uses one worker per hardware thread, minus the main thread
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Schedules a job. The counter (if any) is signaled when the job finishes, and the job is
+		// not started before the dependency counter (if any) reaches zero.
+		static void Execute(JobFunction job, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr);
+
+		// Lowers the counter by one, the same as a job scheduled against it finishing. For counters set by
+		// hand, jobs depending on one are only released when it reaches zero through here
+		static void Signal(JobCounter& counter);
+
+		// Splits [0, count) into chunks of at most grainSize and runs them across all workers.
+		// The non-blocking overload signals the counter once every chunk is finished.
+		static void ParallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function, JobCounter& counter);
+		static void ParallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function);
+
+		// Blocks until the counter reaches zero, running pending jobs on the calling thread meanwhile
+		static void Wait(const JobCounter& counter);
+
+		// Number of threads executing jobs, including the main thread
+		static uint32_t GetThreadCount();
+		// 0 for the main thread, 1..N for workers, UINT32_MAX for threads not owned by the job system
+		static uint32_t GetThreadIndex();
+
+		static bool IsInitialized();
+
+		// Runs jobCount independent jobs, then jobCount jobs linked into dependency chains, then groups gated
+		// on counters signaled by hand the way the system scheduler does. Checks in every build that no job is
+		// lost and none starts before its dependency has finished
+		static JobBenchmarkResult Benchmark(uint32_t jobCount = 100000);
+	};
+
+}
\ No newline at end of file
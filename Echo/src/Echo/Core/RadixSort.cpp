@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "RadixSort.h"
+
+#include "JobSystem.h"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+namespace Echo
+{
+
+	static constexpr uint32_t RadixBits = 8;
+	static constexpr uint32_t RadixSize = 1 << RadixBits;
+
+	// Below this a single chunk beats the cost of scheduling jobs
+	static constexpr uint32_t ParallelThreshold = 64 * 1024;
+
+	using Histogram = std::array<uint32_t, RadixSize>;
+
+	void RadixSort::Sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, uint32_t keyBits, bool parallel)
+	{
+		EC_PROFILE_FUNCTION();
+		EC_CORE_ASSERT(keys.size() == values.size(), "Radix sort needs one value per key!");
+
+		uint32_t count = (uint32_t)keys.size();
+		if (count < 2)
+			return;
+
+		// Kept around so sorting every frame doesn't allocate
+		static thread_local std::vector<uint64_t> s_TempKeys;
+		static thread_local std::vector<uint32_t> s_TempValues;
+		static thread_local std::vector<Histogram> s_Histograms;
+		s_TempKeys.resize(count);
+		s_TempValues.resize(count);
+
+		uint32_t chunkCount = parallel && count >= ParallelThreshold ? JobSystem::GetThreadCount() : 1;
+		uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+		s_Histograms.resize(chunkCount);
+
+		std::vector<uint64_t>* sourceKeys = &keys;
+		std::vector<uint32_t>* sourceValues = &values;
+		std::vector<uint64_t>* destinationKeys = &s_TempKeys;
+		std::vector<uint32_t>* destinationValues = &s_TempValues;
+
+		uint32_t passCount = (std::min(keyBits, 64u) + RadixBits - 1) / RadixBits;
+		for (uint32_t pass = 0; pass < passCount; pass++)
+		{
+			uint32_t shift = pass * RadixBits;
+			const uint64_t* srcKeys = sourceKeys->data();
+
+			JobSystem::ParallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t chunk = begin; chunk < end; chunk++)
+				{
+					Histogram histogram{};
+					uint32_t last = std::min(count, (chunk + 1) * chunkSize);
+					for (uint32_t i = chunk * chunkSize; i < last; i++)
+					{
+						histogram[(srcKeys[i] >> shift) & (RadixSize - 1)]++;
+					}
+					s_Histograms[chunk] = histogram;
+				}
+			});
+
+			// Turn the counts into each chunk's first output index per digit. Chunks of the same digit are
+			// laid out in chunk order, which keeps the sort stable
+			bool skip = false;
+			uint32_t offset = 0;
+			for (uint32_t digit = 0; digit < RadixSize; digit++)
+			{
+				uint32_t digitCount = 0;
+				for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+				{
+					uint32_t chunkDigitCount = s_Histograms[chunk][digit];
+					s_Histograms[chunk][digit] = offset + digitCount;
+					digitCount += chunkDigitCount;
+				}
+
+				if (digitCount == count)
+				{
+					skip = true;
+					break;
+				}
+				offset += digitCount;
+			}
+
+			if (skip)
+				continue;
+
+			const uint32_t* srcValues = sourceValues->data();
+			uint64_t* dstKeys = destinationKeys->data();
+			uint32_t* dstValues = destinationValues->data();
+			JobSystem::ParallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t chunk = begin; chunk < end; chunk++)
+				{
+					// Local copy, the value stores could otherwise alias it
+					Histogram offsets = s_Histograms[chunk];
+
+					uint32_t last = std::min(count, (chunk + 1) * chunkSize);
+					for (uint32_t i = chunk * chunkSize; i < last; i++)
+					{
+						uint32_t index = offsets[(srcKeys[i] >> shift) & (RadixSize - 1)]++;
+						dstKeys[index] = srcKeys[i];
+						dstValues[index] = srcValues[i];
+					}
+				}
+			});
+
+			std::swap(sourceKeys, destinationKeys);
+			std::swap(sourceValues, destinationValues);
+		}
+
+		// An odd number of passes leaves the result in the scratch buffers, trade them with the caller's
+		if (sourceKeys != &keys)
+		{
+			keys.swap(s_TempKeys);
+			values.swap(s_TempValues);
+		}
+	}
+
+	double RadixSort::Benchmark(uint32_t count, bool parallel)
+	{
+		EC_PROFILE_FUNCTION();
+		std::mt19937_64 engine(1234);
+
+		std::vector<uint64_t> keys(count);
+		std::vector<uint32_t> values(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			keys[i] = engine();
+			values[i] = i;
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		Sort(keys, values, 64, parallel);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		EC_CORE_ASSERT(std::is_sorted(keys.begin(), keys.end()), "Radix sort produced unsorted keys!");
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Echo
+{
+
+	class RadixSort
+	{
+	public:
+		// Stable LSD sort of keys together with their values, 8 bits per pass. Only the low keyBits bits
+		// are looked at and passes where every key has the same digit are skipped. Large inputs split
+		// every pass across the job system. Both vectors must have the same size
+		static void Sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, uint32_t keyBits = 64, bool parallel = true);
+
+		// Milliseconds to sort count random 64 bit keys
+		static double Benchmark(uint32_t count = 1000000, bool parallel = true);
+	};
+
+}
\ No newline at end of file
@@ -7,9 +7,9 @@
 namespace Echo 
 {
 
-	static std::random_device s_RandomDevice;
-	static std::mt19937_64 s_Engine(s_RandomDevice());
-	static std::uniform_int_distribution<uint64_t> s_UniformDistribution;
+	// Per thread so UUIDs can be generated from job system workers
+	static thread_local std::mt19937_64 s_Engine(std::random_device{}());
+	static thread_local std::uniform_int_distribution<uint64_t> s_UniformDistribution;
 
 	UUID::UUID()
 		: m_UUID(s_UniformDistribution(s_Engine))
@@ -6,6 +6,7 @@
 #include <fstream>
 
 #include <thread>
+#include <mutex>
 
 namespace Echo
 {
@@ -27,6 +28,7 @@ namespace Echo
 	private:
 		InstrumentationSession* m_CurrentSession;
 		std::ofstream m_OutputStream;
+		std::mutex m_Mutex;
 		int m_ProfileCount;
 	public:
 		Instrumentor()
@@ -51,6 +53,9 @@ namespace Echo
 
 		void WriteProfile(const ProfileResult& result)
 		{
+			// Scopes can close on job system workers
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
 			if (m_ProfileCount++ > 0)
 				m_OutputStream << ",";
 
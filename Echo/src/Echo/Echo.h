@@ -5,6 +5,7 @@
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
 #include "Core/Timestep.h"
+#include "Core/JobSystem.h"
 #include "Core/Layer.h"
 #include "Scene/ScriptableEntity.h"
 #include "Scene/Components.h"
@@ -4,6 +4,8 @@
 namespace Echo 
 {
 
+	static bool s_ParallelRecording = true;
+
 	CommandList::CommandList()
 		: m_CommandBuffer(CommandBuffer::Create())
 	{
@@ -12,24 +14,26 @@ namespace Echo
 
 	void CommandList::Begin() 
 	{
-		m_Commands.clear();
+		m_Commands.Reset();
 		m_CommandBuffer->Start();
 	}
 
-	void CommandList::RecordCommand(Ref<ICommand> command) 
-	{
-		m_Commands.push_back(command);
-	}
-
 	void CommandList::Execute(bool isLastPass)
 	{
-		for (Ref<ICommand> command : m_Commands)
-		{
-			command->Execute(m_CommandBuffer.get());
-		}
+		m_CommandBuffer->Execute(m_Commands, s_ParallelRecording);
 
 		m_CommandBuffer->End();
 		m_CommandBuffer->Submit(isLastPass);
 	}
 
+	void CommandList::SetParallelRecordingEnabled(bool enabled)
+	{
+		s_ParallelRecording = enabled;
+	}
+
+	bool CommandList::IsParallelRecordingEnabled()
+	{
+		return s_ParallelRecording;
+	}
+
 }
\ No newline at end of file
@@ -2,17 +2,19 @@
 
 #include "Core/Base.h"
 
-#include "Commands/ICommand.h"
-#include "Commands/CommandFactory.h"
+#include "Commands/CommandStream.h"
 #include "Primitives/CommandBuffer.h"
 
 #include "Primitives/Framebuffer.h"
 
-#include <vector>
-
 namespace Echo
 {
 
+	// Commands are encoded into a CommandStream while recording and only turned into API calls by Execute.
+	// The stream doesn't hold references, every resource passed in has to outlive Execute.
+	// Begin and Execute belong to the thread running the frame and have to be called in the order the passes
+	// are submitted in. Recording in between touches nothing but the list, so lists can be filled on job
+	// system threads concurrently
 	class CommandList 
 	{
 	public:
@@ -21,27 +23,29 @@ namespace Echo
 		
 		void Begin();
 
-		void ClearColor(Ref<Framebuffer> framebuffer, uint32_t index, const glm::vec4& clearValues) { RecordCommand(CommandFactory::ClearColorCommand(framebuffer, index, clearValues)); }
-		void Dispatch(float x, float y, float z) { RecordCommand(CommandFactory::DispatchCommand(x, y, z)); }
+		void ClearColor(const Ref<Framebuffer>& framebuffer, uint32_t index, const glm::vec4& clearValues) { m_Commands.Push(ClearColorPacket{ framebuffer.get(), index, clearValues }); }
+		void Dispatch(float x, float y, float z) { m_Commands.Push(DispatchPacket{ (uint32_t)x, (uint32_t)y, (uint32_t)z }); }
 
-		void BindPipeline(Ref<Pipeline> pipeline) { RecordCommand(CommandFactory::BindPipelineCommand(pipeline)); }
-		void BindPipeline(Pipeline* pipeline) { RecordCommand(CommandFactory::BindPipelineCommand(pipeline)); }
+		void BindPipeline(const Ref<Pipeline>& pipeline) { m_Commands.Push(BindPipelinePacket{ pipeline.get() }); }
+		void BindPipeline(Pipeline* pipeline) { m_Commands.Push(BindPipelinePacket{ pipeline }); }
 
-		void BindVertexBuffer(Ref<VertexBuffer> vertexBuffer) { RecordCommand(CommandFactory::BindVertexBufferCommand(vertexBuffer)); }
-		void BindIndicesBuffer(Ref<IndexBuffer> indexBuffer) { RecordCommand(CommandFactory::BindIndicesBufferCommand(indexBuffer)); }
+		void BindVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) { m_Commands.Push(BindVertexBufferPacket{ vertexBuffer.get() }); }
+		void BindVertexBuffer(const Ref<StreamingVertexBuffer>& vertexBuffer, const StreamingAllocation& allocation) { m_Commands.Push(BindStreamingVertexBufferPacket{ vertexBuffer.get(), allocation }); }
+		void BindVertexBuffer(const Ref<RetainedVertexBuffer>& vertexBuffer) { m_Commands.Push(BindRetainedVertexBufferPacket{ vertexBuffer.get() }); }
+		void BindIndicesBuffer(const Ref<IndexBuffer>& indexBuffer) { m_Commands.Push(BindIndicesBufferPacket{ indexBuffer.get() }); }
 
-		void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) { RecordCommand(CommandFactory::DrawCommand(vertexCount, instanceCount, firstVertex, firstInstance)); }
-		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance) { RecordCommand(CommandFactory::DrawIndexedCommand(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance)); }
-		void DrawIndirectIndexed(Ref<IndirectBuffer> indirectBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) { RecordCommand(CommandFactory::DrawIndirectIndexed(indirectBuffer, offset, drawCount, stride)); }
+		void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) { m_Commands.Push(DrawPacket{ vertexCount, instanceCount, firstVertex, firstInstance }); }
+		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance) { m_Commands.Push(DrawIndexedPacket{ indexCount, instanceCount, firstIndex, vertexOffset, firstInstance }); }
+		void DrawIndirectIndexed(const Ref<IndirectBuffer>& indirectBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) { m_Commands.Push(DrawIndexedIndirectPacket{ indirectBuffer.get(), offset, drawCount, stride }); }
 
-		void SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) { RecordCommand(CommandFactory::SetScissorCommand(x, y, width, height)); }
-		void SetLineWidth(float lineWidth) { RecordCommand(CommandFactory::SetLineWidthCommand(lineWidth)); }
+		void SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) { m_Commands.Push(SetScissorPacket{ x, y, width, height }); }
+		void SetLineWidth(float lineWidth) { m_Commands.Push(SetLineWidthPacket{ lineWidth }); }
 
-		void BeginRendering(Ref<Framebuffer> framebuffer) { RecordCommand(CommandFactory::BeginRenderingCommand(framebuffer)); }
-		void BeginRendering() { RecordCommand(CommandFactory::BeginRenderingCommand()); }
-		void EndRendering() { RecordCommand(CommandFactory::EndRenderingCommand()); }
+		void BeginRendering(const Ref<Framebuffer>& framebuffer) { m_Commands.Push(BeginRenderingPacket{ framebuffer.get() }); }
+		void BeginRendering() { m_Commands.Push(BeginRenderingPacket{ nullptr }); }
+		void EndRendering() { m_Commands.Push(EndRenderingPacket{}); }
 
-		void RenderImGui() { RecordCommand(CommandFactory::RenderImGuiCommand()); }
+		void RenderImGui() { m_Commands.Push(RenderImGuiPacket{}); }
 
 		void SetSourceFramebuffer(Ref<Framebuffer> framebuffer) { m_CommandBuffer->SetSourceFramebuffer(framebuffer); }
 		void SetShouldPresent(bool shouldPresent) { m_CommandBuffer->SetShouldPresent(shouldPresent); }
@@ -50,10 +54,14 @@ namespace Echo
 		void Execute(bool isLastPass = false);
 
 		Ref<CommandBuffer> GetCommandBuffer() { return m_CommandBuffer; }
+		// What has been recorded since Begin
+		const CommandStream& GetCommands() const { return m_Commands; }
+
+		// Lets Execute record large renderings on the job system into secondary command buffers
+		static void SetParallelRecordingEnabled(bool enabled);
+		static bool IsParallelRecordingEnabled();
 	private:
-		void RecordCommand(Ref<ICommand> command);
-	private:
-		std::vector<Ref<ICommand>> m_Commands;
+		CommandStream m_Commands;
 		Ref<CommandBuffer> m_CommandBuffer;
 	};
 
@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "CommandStream.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace Echo
+{
+
+	static std::mutex s_BlockPoolMutex;
+	static std::vector<void*> s_FreeBlocks;
+
+	CommandStream::~CommandStream()
+	{
+		Reset();
+	}
+
+	void CommandStream::Reset()
+	{
+		if (!m_Blocks.empty())
+		{
+			std::lock_guard<std::mutex> lock(s_BlockPoolMutex);
+			s_FreeBlocks.insert(s_FreeBlocks.end(), m_Blocks.begin(), m_Blocks.end());
+		}
+
+		m_Blocks.clear();
+		m_Current = nullptr;
+		m_CommandCount = 0;
+	}
+
+	CommandStream::Block* CommandStream::AcquireBlock()
+	{
+		Block* block = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(s_BlockPoolMutex);
+			if (!s_FreeBlocks.empty())
+			{
+				block = (Block*)s_FreeBlocks.back();
+				s_FreeBlocks.pop_back();
+			}
+		}
+
+		// Blocks live as long as the program, the pool only ever grows to the most ever recorded at once
+		if (!block)
+			block = new Block();
+
+		block->Used = 0;
+		m_Blocks.push_back(block);
+		return block;
+	}
+
+	double CommandStream::Benchmark(uint32_t commandCount, uint32_t iterations)
+	{
+		EC_PROFILE_FUNCTION();
+		CommandStream stream;
+		uint64_t checksum = 0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++)
+		{
+			stream.Reset();
+
+			// Mix of what Renderer2D records, a pipeline and buffer bind every 8 draws
+			for (uint32_t i = 0; i < commandCount; i++)
+			{
+				switch (i % 10)
+				{
+					case 0: stream.Push(BindPipelinePacket{ nullptr }); break;
+					case 1: stream.Push(BindStreamingVertexBufferPacket{ nullptr, { nullptr, i, 0, i * 64ull } }); break;
+					default: stream.Push(DrawIndexedPacket{ 6, i, 0, 0, i }); break;
+				}
+			}
+
+			stream.ForEach([&checksum](const CommandHeader& header)
+			{
+				switch (header.Type)
+				{
+					case CommandType::BindPipeline: checksum += (uintptr_t)Decode<BindPipelinePacket>(header).Resource; break;
+					case CommandType::BindStreamingVertexBuffer: checksum += Decode<BindStreamingVertexBufferPacket>(header).Allocation.Offset; break;
+					case CommandType::DrawIndexed: checksum += Decode<DrawIndexedPacket>(header).FirstInstance; break;
+					default: break;
+				}
+			});
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		EC_CORE_ASSERT(stream.GetCommandCount() == commandCount, "Command stream lost commands!");
+		// Keeps the decode loop from being optimized away
+		static volatile uint64_t s_Sink;
+		s_Sink = checksum;
+		return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+	}
+
+}
\ No newline at end of file
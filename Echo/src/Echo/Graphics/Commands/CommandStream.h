@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Graphics/Primitives/Framebuffer.h"
+#include "Graphics/Primitives/Pipeline.h"
+#include "Graphics/Primitives/Buffer.h"
+
+#include <glm/glm.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace Echo
+{
+
+	enum class CommandType : uint32_t
+	{
+		ClearColor,
+		Dispatch,
+		BindPipeline,
+		BindVertexBuffer,
+		BindStreamingVertexBuffer,
+		BindRetainedVertexBuffer,
+		BindIndicesBuffer,
+		Draw,
+		DrawIndexed,
+		DrawIndexedIndirect,
+		SetScissor,
+		SetLineWidth,
+		BeginRendering,
+		EndRendering,
+		RenderImGui,
+	};
+
+	// Packets are plain data and only point at the resources they use. Whatever they point at has to stay
+	// alive until the list that recorded them is executed
+	struct ClearColorPacket
+	{
+		static constexpr CommandType Type = CommandType::ClearColor;
+		Framebuffer* Target;
+		uint32_t Index;
+		glm::vec4 ClearValues;
+	};
+
+	struct DispatchPacket
+	{
+		static constexpr CommandType Type = CommandType::Dispatch;
+		uint32_t X, Y, Z;
+	};
+
+	struct BindPipelinePacket
+	{
+		static constexpr CommandType Type = CommandType::BindPipeline;
+		Pipeline* Resource;
+	};
+
+	struct BindVertexBufferPacket
+	{
+		static constexpr CommandType Type = CommandType::BindVertexBuffer;
+		VertexBuffer* Resource;
+	};
+
+	struct BindStreamingVertexBufferPacket
+	{
+		static constexpr CommandType Type = CommandType::BindStreamingVertexBuffer;
+		StreamingVertexBuffer* Resource;
+		StreamingAllocation Allocation;
+	};
+
+	struct BindRetainedVertexBufferPacket
+	{
+		static constexpr CommandType Type = CommandType::BindRetainedVertexBuffer;
+		RetainedVertexBuffer* Resource;
+	};
+
+	struct BindIndicesBufferPacket
+	{
+		static constexpr CommandType Type = CommandType::BindIndicesBuffer;
+		IndexBuffer* Resource;
+	};
+
+	struct DrawPacket
+	{
+		static constexpr CommandType Type = CommandType::Draw;
+		uint32_t VertexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstVertex;
+		uint32_t FirstInstance;
+	};
+
+	struct DrawIndexedPacket
+	{
+		static constexpr CommandType Type = CommandType::DrawIndexed;
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		uint32_t VertexOffset;
+		uint32_t FirstInstance;
+	};
+
+	struct DrawIndexedIndirectPacket
+	{
+		static constexpr CommandType Type = CommandType::DrawIndexedIndirect;
+		IndirectBuffer* Resource;
+		uint32_t Offset;
+		uint32_t DrawCount;
+		uint32_t Stride;
+	};
+
+	struct SetScissorPacket
+	{
+		static constexpr CommandType Type = CommandType::SetScissor;
+		uint32_t X, Y, Width, Height;
+	};
+
+	struct SetLineWidthPacket
+	{
+		static constexpr CommandType Type = CommandType::SetLineWidth;
+		float LineWidth;
+	};
+
+	struct BeginRenderingPacket
+	{
+		static constexpr CommandType Type = CommandType::BeginRendering;
+		// Null renders to the swapchain
+		Framebuffer* Target;
+	};
+
+	struct EndRenderingPacket
+	{
+		static constexpr CommandType Type = CommandType::EndRendering;
+	};
+
+	struct RenderImGuiPacket
+	{
+		static constexpr CommandType Type = CommandType::RenderImGui;
+	};
+
+	struct CommandHeader
+	{
+		CommandType Type;
+		// Bytes up to the next header, this one included
+		uint32_t Size;
+	};
+
+	// Linear arena the commands of a list are written into, header followed by packet, and read back in
+	// recording order. Memory comes in fixed size blocks from a pool shared by every stream, Reset hands
+	// them back, so once the pool has grown to the peak of a frame recording doesn't allocate anymore
+	class CommandStream
+	{
+	public:
+		static constexpr uint32_t BlockSize = 64 * 1024;
+		static constexpr uint32_t PacketAlignment = 8;
+
+		CommandStream() = default;
+		~CommandStream();
+
+		CommandStream(const CommandStream&) = delete;
+		CommandStream& operator=(const CommandStream&) = delete;
+
+		template<typename T>
+		void Push(const T& packet)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "Command packets must be plain data!");
+			static_assert(alignof(T) <= PacketAlignment, "Command packet is over aligned!");
+
+			constexpr uint32_t size = (sizeof(CommandHeader) + sizeof(T) + PacketAlignment - 1) & ~(PacketAlignment - 1);
+			static_assert(size <= BlockSize, "Command packet doesn't fit in a block!");
+
+			uint8_t* data = Allocate(size);
+			new (data) CommandHeader{ T::Type, size };
+			new (data + sizeof(CommandHeader)) T(packet);
+		}
+
+		template<typename T>
+		static const T& Decode(const CommandHeader& header) { return *(const T*)((const uint8_t*)&header + sizeof(CommandHeader)); }
+
+		// Calls fn with the header of every packet in recording order
+		template<typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			for (const Block* block : m_Blocks)
+			{
+				const uint8_t* it = block->Data;
+				const uint8_t* end = block->Data + block->Used;
+				while (it < end)
+				{
+					const CommandHeader& header = *(const CommandHeader*)it;
+					fn(header);
+					it += header.Size;
+				}
+			}
+		}
+
+		// Drops every packet and returns the blocks to the pool
+		void Reset();
+
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+
+		// Milliseconds to record and decode commandCount commands, averaged over iterations
+		static double Benchmark(uint32_t commandCount = 100000, uint32_t iterations = 20);
+	private:
+		struct Block
+		{
+			alignas(PacketAlignment) uint8_t Data[BlockSize];
+			uint32_t Used = 0;
+		};
+
+		uint8_t* Allocate(uint32_t size)
+		{
+			if (!m_Current || m_Current->Used + size > BlockSize)
+				m_Current = AcquireBlock();
+
+			uint8_t* data = m_Current->Data + m_Current->Used;
+			m_Current->Used += size;
+			m_CommandCount++;
+			return data;
+		}
+
+		Block* AcquireBlock();
+	private:
+		std::vector<Block*> m_Blocks;
+		Block* m_Current = nullptr;
+		uint32_t m_CommandCount = 0;
+	};
+
+}
\ No newline at end of file
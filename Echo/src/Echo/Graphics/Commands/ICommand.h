@@ -1,33 +0,0 @@
-#pragma once
-
-#include "Graphics/Primitives/CommandBuffer.h"
-
-namespace Echo 
-{
-
-	enum ImageLayout
-	{
-		General,
-		Undefined,
-		ColorAttachment,
-		DepthAttachment,
-		TransferSrc,
-		TransferDst,
-		ShaderReadOnly,
-	};
-
-	struct Extent2D 
-	{
-		uint32_t Width;
-		uint32_t Height;
-	};
-
-	class ICommand 
-	{
-	public:
-		virtual ~ICommand() = default;
-
-		virtual void Execute(CommandBuffer* cmd) = 0;
-	};
-
-}
\ No newline at end of file
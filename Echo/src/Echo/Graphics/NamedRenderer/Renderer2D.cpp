@@ -7,19 +7,29 @@
 #include "Graphics/Primitives/Material.h"
 #include "Graphics/Primitives/Shader.h"
 
+#include "SpriteKernels.h"
+
+#include "Core/RadixSort.h"
+#include "Core/JobSystem.h"
+
 #include "AssetManager/Assets/ShaderAsset.h"
 
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <chrono>
+#include <unordered_map>
 
 namespace Echo
 {
+	// Packed to the formats tagged on quadShader's VSInput, the layout must match its reflection
 	struct QuadVertex
 	{
 		glm::vec3 Position;
-		glm::vec2 TexCoord;
-		glm::vec4 Color;
-		int TexIndex;
-		float TilingFactor;
+		uint32_t TexCoord; // 2x 16-bit unorm
+		uint32_t Color; // RGBA8 unorm
+		uint16_t TexIndex;
+		uint16_t TilingFactor; // Half float
 
 		int InstanceID;
 	};
@@ -27,14 +37,50 @@ namespace Echo
 	struct CircleVertex
 	{
 		glm::vec3 WorldPosition;
-		glm::vec3 LocalPosition;
-		glm::vec4 Color;
+		uint32_t Color; // RGBA8 unorm
+		uint32_t OutlineFade; // 2x 16-bit unorm, thickness and fade
+
+		int InstanceID;
+		// Index into QuadVertexPositions, the shader derives the local position from it
+		uint8_t Corner;
+	};
+
+	static_assert(sizeof(QuadVertex) == 28, "QuadVertex must match quadShader's packed vertex layout!");
+	static_assert(sizeof(CircleVertex) == 28, "CircleVertex must match circleShader's packed vertex layout!");
+
+	// The first three rows of the model matrix, world = Rows * (corner, 0, 1). Rotations about any axis stay
+	// exact, so instances match the vertex path under the perspective editor camera too
+	struct InstanceTransform
+	{
+		glm::vec4 Rows[3];
+
+		glm::vec3 GetTranslation() const { return { Rows[0].w, Rows[1].w, Rows[2].w }; }
+	};
+
+	// One record per quad, the vertex shader expands the corners
+	struct QuadInstance
+	{
+		InstanceTransform Transform;
+		uint32_t Color;
+		glm::vec4 UVRect;
+		int TexIndex;
+
+		int InstanceID;
+	};
+
+	struct CircleInstance
+	{
+		InstanceTransform Transform;
+		uint32_t Color;
 		float OutlineThickness;
 		float Fade;
 
 		int InstanceID;
 	};
 
+	static_assert(sizeof(QuadInstance) == 76, "QuadInstance must match quadInstancedShader's vertex layout!");
+	static_assert(sizeof(CircleInstance) == 64, "CircleInstance must match circleInstancedShader's vertex layout!");
+
 	struct LineVertex 
 	{
 		glm::vec3 Position;
@@ -52,13 +98,21 @@ namespace Echo
 		uint32_t MaxVertices = MaxQuads * 4;
 		uint32_t MaxIndices = MaxQuads * 6;
 
-		uint32_t MaxTextureSlots;
-
-		Ref<VertexBuffer> QuadVertexBuffer;
-		Ref<VertexBuffer> CircleVertexBuffer;
-		Ref<VertexBuffer> LineVertexBuffer;
+		Ref<StreamingVertexBuffer> QuadVertexBuffer;
+		Ref<StreamingVertexBuffer> CircleVertexBuffer;
+		Ref<StreamingVertexBuffer> LineVertexBuffer;
 		Ref<IndexBuffer> QuadIndexBuffer;
 
+		Ref<StreamingVertexBuffer> QuadInstanceBuffer;
+		Ref<StreamingVertexBuffer> CircleInstanceBuffer;
+
+		// The current batch's regions, see StartBatch
+		StreamingAllocation QuadVertexAllocation;
+		StreamingAllocation CircleVertexAllocation;
+		StreamingAllocation LineVertexAllocation;
+		StreamingAllocation QuadInstanceAllocation;
+		StreamingAllocation CircleInstanceAllocation;
+
 		Ref<ShaderAsset> QuadShader;
 		Ref<Pipeline> QuadPipeline;
 		Ref<ShaderAsset> CircleShader;
@@ -67,6 +121,11 @@ namespace Echo
 		Ref<ShaderAsset> LineShader;
 		Ref<Pipeline> LinePipeline;
 
+		Ref<ShaderAsset> QuadInstancedShader;
+		Ref<Pipeline> QuadInstancedPipeline;
+		Ref<ShaderAsset> CircleInstancedShader;
+		Ref<Pipeline> CircleInstancedPipeline;
+
 		Ref<UniformBuffer> CamUniformBuffer;
 
 		uint32_t QuadIndexCount = 0;
@@ -81,14 +140,26 @@ namespace Echo
 		LineVertex* LineVertexBufferBase = nullptr;
 		LineVertex* LineVertexBufferPtr = nullptr;
 
-		std::vector<Ref<Texture2D>> TextureSlots;
-		uint32_t TextureSlotIndex = 1;
+		bool InstancingEnabled = true;
+		// Latched from InstancingEnabled at BeginScene so a scene never mixes paths halfway
+		bool UseInstancing = true;
+
+		uint32_t QuadInstanceCount = 0;
+		QuadInstance* QuadInstanceBufferBase = nullptr;
 
-		const glm::vec2 QuadTexCoords[4] = {
-			{ 0.0f, 0.0f },
-			{ 1.0f, 0.0f },
-			{ 1.0f, 1.0f },
-			{ 0.0f, 1.0f }
+		uint32_t CircleInstanceCount = 0;
+		CircleInstance* CircleInstanceBufferBase = nullptr;
+
+		// Sampled by untextured quads
+		Ref<Texture2D> WhiteTexture;
+		int WhiteTextureIndex = 0;
+
+		// Packed 16-bit unorm (0,0), (1,0), (1,1), (0,1)
+		const uint32_t QuadTexCoords[4] = {
+			0x00000000,
+			0x0000ffff,
+			0xffffffff,
+			0xffff0000
 		};
 
 		const glm::vec4 QuadVertexPositions[4] = {
@@ -98,18 +169,187 @@ namespace Echo
 			{ -0.5f, 0.5f, 0.0f, 1.0f }
 		};
 
+		// Off by default: sorted scenes feed every visible retained sprite through the sort and the streaming
+		// buffers each frame, giving up what retained batches save for static sprites
+		bool SortingEnabled = false;
+		// Latched at BeginScene like UseInstancing
+		bool UseSorting = false;
+		SortKeyLayout KeyLayout;
+		glm::mat4 ProjView = glm::mat4(1.0f);
+
+		// One key per sorted submission, the value indexes SortedQuads or, with SortedCircleBit set, SortedCircles
+		std::vector<uint64_t> SortKeys;
+		std::vector<uint32_t> SortValues;
+		std::vector<QuadInstance> SortedQuads;
+		std::vector<CircleInstance> SortedCircles;
+
+		// One per DrawParallel chunk, kept around so the vector doesn't reallocate every frame
+		std::vector<BatchBuilder2D> Builders;
+
+		// Instances up to these were already drawn from the current batch's regions
+		uint32_t QuadInstanceDrawn = 0;
+		uint32_t CircleInstanceDrawn = 0;
+
+		SIMDLevel KernelLevel = SIMDLevel::Scalar;
+		SpriteTransformKernel TransformKernel = nullptr;
+		SpriteCullKernel CullKernel = nullptr;
+
+		bool CullingEnabled = true;
+		// Latched at BeginScene like UseInstancing
+		bool UseCulling = true;
+		Frustum ViewFrustum;
+
 		Statistics Stats;
 		CommandList* Cmd;
 	};
 
 	static RendererQuadData s_Data;
 
+	static constexpr uint32_t SortedCircleBit = 1u << 31;
+
+	// Values of SortKeyField::Pipeline
+	enum class SortPipeline : uint8_t
+	{
+		Quad = 0,
+		Circle
+	};
+
+	uint32_t SortKeyLayout::GetTotalBits() const
+	{
+		uint32_t bits = 0;
+		for (uint8_t fieldBits : Bits)
+		{
+			bits += fieldBits;
+		}
+		return bits;
+	}
+
+	SortKeyLayout SortKeyLayout::Opaque()
+	{
+		SortKeyLayout layout;
+		layout.Order[0] = SortKeyField::Layer;
+		layout.Order[1] = SortKeyField::Pipeline;
+		layout.Order[2] = SortKeyField::Texture;
+		layout.Order[3] = SortKeyField::Depth;
+		layout.Order[4] = SortKeyField::Entity;
+		layout.BackToFront = false;
+		return layout;
+	}
+
+	static uint64_t MakeSortKey(uint8_t layer, const glm::vec3& position, SortPipeline pipeline, int textureIndex, int instanceID)
+	{
+		const SortKeyLayout& layout = s_Data.KeyLayout;
+
+		// Normalized device depth, 0 at the near plane
+		glm::vec4 clip = s_Data.ProjView * glm::vec4(position, 1.0f);
+		float depth = clip.w != 0.0f ? glm::clamp(clip.z / clip.w, 0.0f, 1.0f) : 0.0f;
+		if (layout.BackToFront)
+			depth = 1.0f - depth;
+
+		uint32_t depthBits = layout.Bits[(size_t)SortKeyField::Depth];
+		uint64_t fields[(size_t)SortKeyField::Count];
+		fields[(size_t)SortKeyField::Layer] = layer;
+		fields[(size_t)SortKeyField::Depth] = depthBits ? (uint64_t)(depth * (float)((1ull << depthBits) - 1)) : 0;
+		fields[(size_t)SortKeyField::Pipeline] = (uint64_t)pipeline;
+		fields[(size_t)SortKeyField::Texture] = (uint32_t)textureIndex;
+		fields[(size_t)SortKeyField::Entity] = (uint32_t)instanceID;
+
+		uint64_t key = 0;
+		for (SortKeyField field : layout.Order)
+		{
+			uint32_t bits = layout.Bits[(size_t)field];
+			if (bits == 0)
+				continue;
+
+			uint64_t mask = bits >= 64 ? ~0ull : (1ull << bits) - 1;
+			key = (bits >= 64 ? 0 : key << bits) | (fields[(size_t)field] & mask);
+		}
+		return key;
+	}
+
+	static uint32_t PackColor(const glm::vec4& color)
+	{
+		glm::vec4 scaled = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+		return (uint32_t)scaled.r | ((uint32_t)scaled.g << 8) | ((uint32_t)scaled.b << 16) | ((uint32_t)scaled.a << 24);
+	}
+
+	static InstanceTransform ToInstanceTransform(const glm::mat4& transform)
+	{
+		InstanceTransform result;
+		for (int row = 0; row < 3; row++)
+		{
+			result.Rows[row] = { transform[0][row], transform[1][row], transform[2][row], transform[3][row] };
+		}
+		return result;
+	}
+
+	// Transform of a sprite lying in the xy plane, from its scaled local x (xy) and y (zw) axes
+	static InstanceTransform ToInstanceTransform(const glm::vec4& axes, const glm::vec3& translation)
+	{
+		InstanceTransform result;
+		result.Rows[0] = { axes.x, axes.z, 0.0f, translation.x };
+		result.Rows[1] = { axes.y, axes.w, 0.0f, translation.y };
+		result.Rows[2] = { 0.0f, 0.0f, 1.0f, translation.z };
+		return result;
+	}
+
+	// World space half extents of a unit quad under the transform
+	static glm::vec3 GetQuadExtents(const InstanceTransform& transform)
+	{
+		glm::vec3 extents;
+		for (int row = 0; row < 3; row++)
+		{
+			extents[row] = 0.5f * (std::abs(transform.Rows[row].x) + std::abs(transform.Rows[row].y));
+		}
+		return extents;
+	}
+
+	// Safe to call from any thread while recording, the frustum only changes at BeginScene
+	static bool IntersectsView(const InstanceTransform& transform)
+	{
+		return !s_Data.UseCulling || s_Data.ViewFrustum.IntersectsAABB(transform.GetTranslation(), GetQuadExtents(transform));
+	}
+
+	// Main thread only, counts the result in the stats
+	static bool IsVisible(const InstanceTransform& transform)
+	{
+		if (!s_Data.UseCulling)
+			return true;
+
+		bool visible = IntersectsView(transform);
+		if (visible)
+			s_Data.Stats.VisibleCount++;
+		else
+			s_Data.Stats.CulledCount++;
+		return visible;
+	}
+
+	static QuadInstance MakeQuadInstance(const VertexQuadData& data, const glm::mat4& transform, int textureIndex)
+	{
+		QuadInstance instance;
+		instance.Transform = ToInstanceTransform(transform);
+		instance.Color = PackColor(data.Color);
+		instance.UVRect = { 0.0f, 0.0f, data.TilingFactor, data.TilingFactor };
+		instance.TexIndex = textureIndex;
+		instance.InstanceID = data.InstanceID;
+		return instance;
+	}
+
+	static CircleInstance MakeCircleInstance(const VertexCircleData& data, const glm::mat4& transform)
+	{
+		CircleInstance instance;
+		instance.Transform = ToInstanceTransform(transform);
+		instance.Color = PackColor(data.Color);
+		instance.OutlineThickness = data.OutlineThickness;
+		instance.Fade = data.Fade;
+		instance.InstanceID = data.InstanceID;
+		return instance;
+	}
+
 	void Renderer2D::Init(Ref<Framebuffer> framebuffer, uint32_t index)
 	{
 		EC_PROFILE_FUNCTION();
 
-		s_Data.MaxTextureSlots = Application::Get().GetWindow().GetDevice()->GetMaxTextureSlots();
-
 		PipelineSpecification pipelineSpec{};
 		pipelineSpec.CullMode = Cull::None;
 		pipelineSpec.EnableBlending = true;
@@ -124,24 +364,38 @@ namespace Echo
 		s_Data.LineShader = AssetRegistry::LoadAsset<ShaderAsset>("Resources/shaders/lineShader.slang");
 		s_Data.LinePipeline = Pipeline::Create(s_Data.LineShader->GetShader(), pipelineSpec);
 
+		pipelineSpec.GraphicsTopology = Topology::TriangleList;
+		pipelineSpec.LineWidth = 1.0f;
+		pipelineSpec.InputRate = VertexInputRate::Instance;
+		s_Data.QuadInstancedShader = AssetRegistry::LoadAsset<ShaderAsset>("Resources/shaders/quadInstancedShader.slang");
+		s_Data.QuadInstancedPipeline = Pipeline::Create(s_Data.QuadInstancedShader->GetShader(), pipelineSpec);
+		s_Data.CircleInstancedShader = AssetRegistry::LoadAsset<ShaderAsset>("Resources/shaders/circleInstancedShader.slang");
+		s_Data.CircleInstancedPipeline = Pipeline::Create(s_Data.CircleInstancedShader->GetShader(), pipelineSpec);
+
 		s_Data.QuadShader->SetPipeline(s_Data.QuadPipeline);
 		s_Data.CircleShader->SetPipeline(s_Data.CirclePipeline);
 		s_Data.LineShader->SetPipeline(s_Data.LinePipeline);
+		s_Data.QuadInstancedShader->SetPipeline(s_Data.QuadInstancedPipeline);
+		s_Data.CircleInstancedShader->SetPipeline(s_Data.CircleInstancedPipeline);
 
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex), true);
-		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex), true);
-		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex), true);
+		// Batches are written straight into these, one full batch per block
+		s_Data.QuadVertexBuffer = StreamingVertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
+		s_Data.CircleVertexBuffer = StreamingVertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex));
+		s_Data.LineVertexBuffer = StreamingVertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex));
+		s_Data.QuadInstanceBuffer = StreamingVertexBuffer::Create(s_Data.MaxQuads * sizeof(QuadInstance));
+		s_Data.CircleInstanceBuffer = StreamingVertexBuffer::Create(s_Data.MaxQuads * sizeof(CircleInstance));
 
-		s_Data.TextureSlots.resize(s_Data.MaxTextureSlots);
-		s_Data.TextureSlots[0] = Texture2D::Create(1, 1, new uint32_t(0xffffffff));
+		s_Data.KernelLevel = CPUInfo::GetSIMDLevel();
+		s_Data.TransformKernel = SpriteKernels::GetTransformKernel(s_Data.KernelLevel);
+		s_Data.CullKernel = SpriteKernels::GetCullKernel(s_Data.KernelLevel);
+		EC_CORE_INFO("Renderer2D sprite kernels: {0}", CPUInfo::SIMDLevelToString(s_Data.KernelLevel));
+
+		s_Data.WhiteTexture = Texture2D::Create(1, 1, new uint32_t(0xffffffff));
+		s_Data.WhiteTextureIndex = (int)s_Data.WhiteTexture->GetBindlessIndex();
 
 		CameraUniformBuffer batchUniformBuffer{};
 		s_Data.CamUniformBuffer = UniformBuffer::Create(&batchUniformBuffer, sizeof(CameraUniformBuffer));
 
-		s_Data.QuadVertexBufferBase = new QuadVertex[s_Data.MaxVertices];
-		s_Data.CircleVertexBufferBase = new CircleVertex[s_Data.MaxVertices];
-		s_Data.LineVertexBufferBase = new LineVertex[s_Data.MaxVertices];
-
 		uint32_t* quadIndices = new uint32_t[s_Data.MaxIndices];
 
 		uint32_t offset = 0;
@@ -165,8 +419,17 @@ namespace Echo
 	void Renderer2D::BeginScene(CommandList& cmd, const Camera& camera, const glm::mat4& transform)
 	{
 		EC_PROFILE_FUNCTION();
-		glm::mat4 projView = camera.GetProjection() * glm::inverse(transform);
+		StartScene(cmd, camera.GetProjection() * glm::inverse(transform));
+	}
+
+	void Renderer2D::BeginScene(CommandList& cmd, const EditorCamera& camera)
+	{
+		EC_PROFILE_FUNCTION();
+		StartScene(cmd, camera.GetProjection() * camera.GetViewMatrix());
+	}
 
+	void Renderer2D::StartScene(CommandList& cmd, const glm::mat4& projView)
+	{
 		CameraUniformBuffer camUniformBuffer
 		{
 			.ProjViewMatrix = projView,
@@ -174,10 +437,41 @@ namespace Echo
 		s_Data.CamUniformBuffer->SetData(&camUniformBuffer, sizeof(CameraUniformBuffer));
 
 		s_Data.Cmd = &cmd;
+		s_Data.UseInstancing = s_Data.InstancingEnabled;
+		s_Data.UseSorting = s_Data.SortingEnabled;
+		s_Data.UseCulling = s_Data.CullingEnabled;
+		s_Data.ProjView = projView;
+		s_Data.ViewFrustum = Frustum::FromViewProjection(projView);
+
+		s_Data.QuadPipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+		s_Data.CirclePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+		s_Data.QuadInstancedPipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+		s_Data.CircleInstancedPipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+		s_Data.LinePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+
+		s_Data.Cmd->BindIndicesBuffer(s_Data.QuadIndexBuffer);
+
+		StartBatch();
+	}
+
+	void Renderer2D::StartBatch()
+	{
+		// Every batch gets regions of its own, so batches recorded earlier in the frame keep their data.
+		// Flush gives back whatever the batch didn't use
+		s_Data.QuadVertexAllocation = s_Data.QuadVertexBuffer->Allocate(s_Data.MaxVertices * sizeof(QuadVertex));
+		s_Data.CircleVertexAllocation = s_Data.CircleVertexBuffer->Allocate(s_Data.MaxVertices * sizeof(CircleVertex));
+		s_Data.LineVertexAllocation = s_Data.LineVertexBuffer->Allocate(s_Data.MaxVertices * sizeof(LineVertex));
+		s_Data.QuadInstanceAllocation = s_Data.QuadInstanceBuffer->Allocate(s_Data.MaxQuads * sizeof(QuadInstance));
+		s_Data.CircleInstanceAllocation = s_Data.CircleInstanceBuffer->Allocate(s_Data.MaxQuads * sizeof(CircleInstance));
+
+		s_Data.QuadVertexBufferBase = (QuadVertex*)s_Data.QuadVertexAllocation.Data;
+		s_Data.CircleVertexBufferBase = (CircleVertex*)s_Data.CircleVertexAllocation.Data;
+		s_Data.LineVertexBufferBase = (LineVertex*)s_Data.LineVertexAllocation.Data;
+		s_Data.QuadInstanceBufferBase = (QuadInstance*)s_Data.QuadInstanceAllocation.Data;
+		s_Data.CircleInstanceBufferBase = (CircleInstance*)s_Data.CircleInstanceAllocation.Data;
 
 		s_Data.QuadIndexCount = 0;
 		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
-		s_Data.TextureSlotIndex = 1;
 
 		s_Data.CircleIndexCount = 0;
 		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
@@ -185,206 +479,555 @@ namespace Echo
 		s_Data.LineCount = 0;
 		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
 
-		cmd.BindPipeline(s_Data.QuadPipeline);
+		s_Data.QuadInstanceCount = 0;
+		s_Data.CircleInstanceCount = 0;
+		s_Data.QuadInstanceDrawn = 0;
+		s_Data.CircleInstanceDrawn = 0;
+	}
 
-		s_Data.QuadPipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+	void Renderer2D::EndScene()
+	{
+		EC_PROFILE_FUNCTION();
+		FlushSorted();
+		Flush();
+	}
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.QuadVertexBuffer);
-		s_Data.Cmd->BindIndicesBuffer(s_Data.QuadIndexBuffer);
+	int Renderer2D::GetTextureIndex(const Ref<Texture2D>& texture)
+	{
+		if (texture == nullptr)
+			return s_Data.WhiteTextureIndex;
 
-		cmd.BindPipeline(s_Data.CirclePipeline);
+		uint32_t index = texture->GetBindlessIndex();
+		return index != Texture2D::InvalidBindlessIndex ? (int)index : s_Data.WhiteTextureIndex;
+	}
 
-		s_Data.CirclePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+	void Renderer2D::DrawQuad(const VertexQuadData& data)
+	{
+		EC_PROFILE_FUNCTION();
+		if (!s_Data.UseInstancing && !s_Data.UseSorting)
+		{
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), data.Position)
+				* glm::rotate(glm::mat4(1.0f), glm::radians(data.Rotation), { 0.0f, 0.0f, 1.0f })
+				* glm::scale(glm::mat4(1.0f), { data.Size.x, data.Size.y, 1.0f });
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.CircleVertexBuffer);
-		s_Data.Cmd->BindIndicesBuffer(s_Data.QuadIndexBuffer);
-		
-		cmd.BindPipeline(s_Data.LinePipeline);
-		
-		s_Data.LinePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+			DrawQuad(data, transform);
+			return;
+		}
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.LineVertexBuffer);
+		// Rotation and scale only, no matrix needed
+		float rotation = glm::radians(data.Rotation);
+		float c = glm::cos(rotation);
+		float s = glm::sin(rotation);
+
+		QuadInstance instance;
+		instance.Transform = ToInstanceTransform({ c * data.Size.x, s * data.Size.x, -s * data.Size.y, c * data.Size.y }, data.Position);
+		if (!IsVisible(instance.Transform))
+			return;
+
+		instance.Color = PackColor(data.Color);
+		instance.UVRect = { 0.0f, 0.0f, data.TilingFactor, data.TilingFactor };
+		instance.TexIndex = GetTextureIndex(data.Texture);
+		instance.InstanceID = data.InstanceID;
+		SubmitQuadInstance(instance, data.SortLayer);
 	}
 
-	void Renderer2D::BeginScene(CommandList& cmd, const EditorCamera& camera)
+	void Renderer2D::DrawQuad(const VertexQuadData& data, const glm::mat4& transform)
 	{
 		EC_PROFILE_FUNCTION();
-		CameraUniformBuffer camUniformBuffer
+		if (s_Data.UseInstancing || s_Data.UseSorting)
 		{
-			.ProjViewMatrix = camera.GetProjection() * camera.GetViewMatrix(),
-		};
-		s_Data.CamUniformBuffer->SetData(&camUniformBuffer, sizeof(CameraUniformBuffer));
+			QuadInstance instance = MakeQuadInstance(data, transform, GetTextureIndex(data.Texture));
+			if (IsVisible(instance.Transform))
+				SubmitQuadInstance(instance, data.SortLayer);
+			return;
+		}
 
-		s_Data.Cmd = &cmd;
+		if (!IsVisible(ToInstanceTransform(transform)))
+			return;
 
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
-		s_Data.TextureSlotIndex = 1;
+		if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
+			FlushAndReset();
 
-		s_Data.CircleIndexCount = 0;
-		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
+		uint16_t textureIndex = (uint16_t)GetTextureIndex(data.Texture);
+		uint32_t color = PackColor(data.Color);
+		uint16_t tilingFactor = glm::packHalf1x16(data.TilingFactor);
 
-		s_Data.LineCount = 0;
-		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
+		for (int i = 0; i < 4; i++)
+		{
+			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
+			s_Data.QuadVertexBufferPtr->TexCoord = s_Data.QuadTexCoords[i];
+			s_Data.QuadVertexBufferPtr->Color = color;
+			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
+			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
+			s_Data.QuadVertexBufferPtr->InstanceID = data.InstanceID;
+			s_Data.QuadVertexBufferPtr++;
+		}
 
-		cmd.BindPipeline(s_Data.QuadPipeline);
+		s_Data.QuadIndexCount += 6;
+		s_Data.Stats.QuadCount++;
+	}
 
-		s_Data.QuadPipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+	void Renderer2D::DrawQuads(std::span<const VertexQuadData> quads)
+	{
+		EC_PROFILE_FUNCTION();
+		// Staged as float arrays in chunks, the kernel handles the whole chunk in one call
+		constexpr uint32_t ChunkSize = 256;
+		alignas(32) float positionX[ChunkSize], positionY[ChunkSize];
+		alignas(32) float sizeX[ChunkSize], sizeY[ChunkSize], rotation[ChunkSize];
+		alignas(32) float axes[4][ChunkSize];
+		alignas(32) float cornerX[4][ChunkSize], cornerY[4][ChunkSize];
+		alignas(32) float positionZ[ChunkSize], extentX[ChunkSize], extentY[ChunkSize];
+		uint8_t visible[ChunkSize];
+
+		SpriteTransformOutput output;
+		output.AxisXx = axes[0];
+		output.AxisXy = axes[1];
+		output.AxisYx = axes[2];
+		output.AxisYy = axes[3];
+		// The instanced path only needs the axes, the vertex shader expands the corners
+		bool instanced = s_Data.UseInstancing || s_Data.UseSorting;
+		if (!instanced)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				output.CornerX[k] = cornerX[k];
+				output.CornerY[k] = cornerY[k];
+			}
+		}
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.QuadVertexBuffer);
-		s_Data.Cmd->BindIndicesBuffer(s_Data.QuadIndexBuffer);
+		for (size_t begin = 0; begin < quads.size(); begin += ChunkSize)
+		{
+			uint32_t count = (uint32_t)std::min<size_t>(ChunkSize, quads.size() - begin);
+			const VertexQuadData* chunk = quads.data() + begin;
 
-		cmd.BindPipeline(s_Data.CirclePipeline);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				positionX[i] = chunk[i].Position.x;
+				positionY[i] = chunk[i].Position.y;
+				sizeX[i] = chunk[i].Size.x;
+				sizeY[i] = chunk[i].Size.y;
+				rotation[i] = glm::radians(chunk[i].Rotation);
+			}
 
-		s_Data.CirclePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+			SpriteTransformInput input
+			{
+				.PositionX = positionX,
+				.PositionY = positionY,
+				.SizeX = sizeX,
+				.SizeY = sizeY,
+				.Rotation = rotation,
+				.Count = count
+			};
+			s_Data.TransformKernel(input, output);
+
+			if (s_Data.UseCulling)
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					positionZ[i] = chunk[i].Position.z;
+					extentX[i] = 0.5f * (std::abs(axes[0][i]) + std::abs(axes[2][i]));
+					extentY[i] = 0.5f * (std::abs(axes[1][i]) + std::abs(axes[3][i]));
+				}
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.CircleVertexBuffer);
-		s_Data.Cmd->BindIndicesBuffer(s_Data.QuadIndexBuffer);
+				SpriteBoundsInput bounds
+				{
+					.CenterX = positionX,
+					.CenterY = positionY,
+					.CenterZ = positionZ,
+					.ExtentX = extentX,
+					.ExtentY = extentY,
+					.Count = count
+				};
+				uint32_t visibleCount = s_Data.CullKernel(s_Data.ViewFrustum, bounds, visible);
+				s_Data.Stats.VisibleCount += visibleCount;
+				s_Data.Stats.CulledCount += count - visibleCount;
+			}
 
-		cmd.BindPipeline(s_Data.LinePipeline);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (s_Data.UseCulling && !visible[i])
+					continue;
 
-		s_Data.LinePipeline->BindResource(0, 0, s_Data.CamUniformBuffer);
+				const VertexQuadData& data = chunk[i];
+				int textureIndex = GetTextureIndex(data.Texture);
 
-		s_Data.Cmd->BindVertexBuffer(s_Data.LineVertexBuffer);
+				if (instanced)
+				{
+					QuadInstance instance;
+					instance.Transform = ToInstanceTransform({ axes[0][i], axes[1][i], axes[2][i], axes[3][i] }, data.Position);
+					instance.Color = PackColor(data.Color);
+					instance.UVRect = { 0.0f, 0.0f, data.TilingFactor, data.TilingFactor };
+					instance.TexIndex = textureIndex;
+					instance.InstanceID = data.InstanceID;
+					SubmitQuadInstance(instance, data.SortLayer);
+				}
+				else
+				{
+					if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
+						FlushAndReset();
+
+					uint32_t color = PackColor(data.Color);
+					uint16_t tilingFactor = glm::packHalf1x16(data.TilingFactor);
+
+					for (int k = 0; k < 4; k++)
+					{
+						s_Data.QuadVertexBufferPtr->Position = { cornerX[k][i], cornerY[k][i], data.Position.z };
+						s_Data.QuadVertexBufferPtr->TexCoord = s_Data.QuadTexCoords[k];
+						s_Data.QuadVertexBufferPtr->Color = color;
+						s_Data.QuadVertexBufferPtr->TexIndex = (uint16_t)textureIndex;
+						s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
+						s_Data.QuadVertexBufferPtr->InstanceID = data.InstanceID;
+						s_Data.QuadVertexBufferPtr++;
+					}
+
+					s_Data.QuadIndexCount += 6;
+					s_Data.Stats.QuadCount++;
+				}
+			}
+		}
 	}
 
-	void Renderer2D::EndScene()
+	void Renderer2D::DrawRetained(const Ref<RetainedQuadBatch>& batch)
 	{
 		EC_PROFILE_FUNCTION();
-		uint32_t quadDataSize = (uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase;
-		if (quadDataSize != 0)
+		uint32_t slotCount = batch->GetSlotCount();
+		if (slotCount == 0)
+			return;
+
+		const uint8_t* visible = nullptr;
+		uint32_t visibleCount = batch->GetQuadCount();
+		if (s_Data.UseCulling)
 		{
-			s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, quadDataSize);
+			SpriteBoundsInput bounds
+			{
+				.CenterX = batch->m_CenterX.data(),
+				.CenterY = batch->m_CenterY.data(),
+				.CenterZ = batch->m_CenterZ.data(),
+				.ExtentX = batch->m_ExtentX.data(),
+				.ExtentY = batch->m_ExtentY.data(),
+				.ExtentZ = batch->m_ExtentZ.data(),
+				.Count = slotCount
+			};
+			batch->m_Visible.resize(slotCount);
+			visibleCount = s_Data.CullKernel(s_Data.ViewFrustum, bounds, batch->m_Visible.data());
+			visible = batch->m_Visible.data();
+
+			s_Data.Stats.VisibleCount += visibleCount;
+			s_Data.Stats.CulledCount += batch->GetQuadCount() - visibleCount;
 		}
+		s_Data.Stats.RetainedQuadCount += visibleCount;
 
-		uint32_t circleDataSize = (uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase;
-		if (circleDataSize != 0)
+		if (s_Data.UseSorting)
 		{
-			s_Data.CircleVertexBuffer->SetData(s_Data.CircleVertexBufferBase, circleDataSize);
+			// The retained buffer can't be drawn in key order, so the slots go through the sort from their
+			// CPU copies like any other quad. Removed slots have negative extents
+			for (uint32_t slot = 0; slot < slotCount; slot++)
+			{
+				if (visible ? !visible[slot] : batch->m_ExtentX[slot] < 0.0f)
+					continue;
+
+				SubmitQuadInstance(batch->m_Instances[slot], batch->m_SortLayers[slot]);
+			}
+			return;
 		}
 
-		uint32_t lineDataSize = (uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase;
-		if (lineDataSize != 0) 
+		s_Data.Cmd->BindPipeline(s_Data.QuadInstancedPipeline);
+		s_Data.Cmd->BindVertexBuffer(batch->m_Buffer);
+		s_Data.Stats.QuadCount += visibleCount;
+
+		if (!visible)
 		{
-			s_Data.LineVertexBuffer->SetData(s_Data.LineVertexBufferBase, lineDataSize);
+			s_Data.Cmd->DrawIndexed(6, slotCount, 0, 0, 0);
+			s_Data.Stats.DrawCalls++;
+			return;
+		}
+
+		// Short gaps are drawn along with their neighbours, an off screen quad costs less than another draw
+		constexpr uint32_t MaxGap = 64;
+		uint32_t slot = 0;
+		while (slot < slotCount)
+		{
+			if (!visible[slot])
+			{
+				slot++;
+				continue;
+			}
+
+			uint32_t runBegin = slot;
+			uint32_t runEnd = slot + 1;
+			uint32_t gap = 0;
+			for (slot = runEnd; slot < slotCount && gap <= MaxGap; slot++)
+			{
+				if (visible[slot])
+				{
+					runEnd = slot + 1;
+					gap = 0;
+				}
+				else
+				{
+					gap++;
+				}
+			}
+			slot = runEnd;
+
+			s_Data.Cmd->DrawIndexed(6, runEnd - runBegin, 0, 0, runBegin);
+			s_Data.Stats.DrawCalls++;
 		}
-		
-		if(quadDataSize != 0 || circleDataSize != 0 || lineDataSize != 0) Flush();
 	}
 
-	void Renderer2D::DrawQuad(const VertexQuadData& data)
+	void Renderer2D::DrawParallel(uint32_t count, uint32_t grainSize, const ParallelRecordFunction& record)
 	{
 		EC_PROFILE_FUNCTION();
-		if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
-			FlushAndReset();
+		if (count == 0)
+			return;
 
-		if (s_Data.TextureSlotIndex >= s_Data.MaxTextureSlots)
-			FlushAndReset();
+		grainSize = std::max(grainSize, 1u);
+		// Matches JobSystem::ParallelFor's chunks, which start at multiples of the grain size
+		uint32_t builderCount = (count + grainSize - 1) / grainSize;
+		s_Data.Builders.assign(builderCount, BatchBuilder2D{});
 
-		float textureIndex = 0.0f;
+		StreamingAllocation quadAllocation{};
+		StreamingAllocation circleAllocation{};
+		QuadInstance* quads = nullptr;
+		CircleInstance* circles = nullptr;
 
-		if (data.Texture != nullptr)
+		uint32_t quadBase = 0, circleBase = 0, keyBase = 0;
+		if (s_Data.UseSorting)
 		{
-			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
-			{
-				if (*s_Data.TextureSlots[i].get() == *data.Texture.get())
-				{
-					textureIndex = (float)i;
-					break;
-				}
-			}
+			// Sorted instances stay on the CPU until FlushSorted, every builder gets slices of the sort arrays
+			quadBase = (uint32_t)s_Data.SortedQuads.size();
+			circleBase = (uint32_t)s_Data.SortedCircles.size();
+			keyBase = (uint32_t)s_Data.SortKeys.size();
+			s_Data.SortedQuads.resize(quadBase + count);
+			s_Data.SortedCircles.resize(circleBase + count);
+			s_Data.SortKeys.resize(keyBase + count * 2);
+			s_Data.SortValues.resize(keyBase + count * 2);
+
+			quads = s_Data.SortedQuads.data() + quadBase;
+			circles = s_Data.SortedCircles.data() + circleBase;
+		}
+		else
+		{
+			// Everything batched so far goes first, then the builders write straight into fresh regions
+			Flush();
+			quadAllocation = s_Data.QuadInstanceBuffer->Allocate(count * sizeof(QuadInstance));
+			circleAllocation = s_Data.CircleInstanceBuffer->Allocate(count * sizeof(CircleInstance));
+			quads = (QuadInstance*)quadAllocation.Data;
+			circles = (CircleInstance*)circleAllocation.Data;
+		}
 
-			if (textureIndex == 0.0f)
+		JobSystem::ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end)
+		{
+			BatchBuilder2D& builder = s_Data.Builders[begin / grainSize];
+			builder.m_Quads = quads + begin;
+			builder.m_Circles = circles + begin;
+			builder.m_Capacity = end - begin;
+			if (s_Data.UseSorting)
 			{
-				textureIndex = (float)s_Data.TextureSlotIndex;
-				s_Data.TextureSlots[s_Data.TextureSlotIndex] = data.Texture;
-				s_Data.TextureSlotIndex++;
+				builder.m_SortKeys = s_Data.SortKeys.data() + keyBase + begin * 2;
+				builder.m_SortValues = s_Data.SortValues.data() + keyBase + begin * 2;
+				builder.m_QuadBase = quadBase + begin;
+				builder.m_CircleBase = circleBase + begin;
 			}
 
-		}
-
-		glm::mat4 transform = glm::translate(glm::mat4(1.0f), data.Position)
-			* glm::rotate(glm::mat4(1.0f), glm::radians(data.Rotation), { 0.0f, 0.0f, 1.0f })
-			* glm::scale(glm::mat4(1.0f), { data.Size.x, data.Size.y, 1.0f });
+			record(builder, begin, end);
+		});
 
-		for (int i = 0; i < 4; i++)
+		uint32_t quadCount = 0, circleCount = 0, culledCount = 0;
+		for (const BatchBuilder2D& builder : s_Data.Builders)
 		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->TexCoord = s_Data.QuadTexCoords[i];
-			s_Data.QuadVertexBufferPtr->Color = data.Color;
-			s_Data.QuadVertexBufferPtr->TexIndex = (int)textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = data.TilingFactor;
-			s_Data.QuadVertexBufferPtr->InstanceID = data.InstanceID;
-			s_Data.QuadVertexBufferPtr++;
+			quadCount += builder.m_QuadCount;
+			circleCount += builder.m_CircleCount;
+			culledCount += builder.m_CulledCount;
 		}
 
-		s_Data.QuadIndexCount += 6;
-		s_Data.Stats.QuadCount++;
-	}
+		if (s_Data.UseCulling)
+		{
+			s_Data.Stats.CulledCount += culledCount;
+			s_Data.Stats.VisibleCount += quadCount + circleCount;
+		}
 
-	void Renderer2D::DrawQuad(const VertexQuadData& data, const glm::mat4& transform)
-	{
-		EC_PROFILE_FUNCTION();
-		if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
-			FlushAndReset();
+		s_Data.Stats.QuadCount += quadCount;
+		s_Data.Stats.InstancedQuadCount += quadCount;
+		s_Data.Stats.CircleCount += circleCount;
+		s_Data.Stats.InstancedCircleCount += circleCount;
 
-		if (s_Data.TextureSlotIndex >= s_Data.MaxTextureSlots)
-			FlushAndReset();
+		if (s_Data.UseSorting)
+		{
+			// Close the gaps between the builders' key slices, FlushSorted sorts them with everything else
+			uint32_t keyCount = keyBase;
+			for (const BatchBuilder2D& builder : s_Data.Builders)
+			{
+				if (builder.m_SortCount == 0)
+					continue;
 
-		float textureIndex = 0.0f;
+				if (builder.m_SortKeys != s_Data.SortKeys.data() + keyCount)
+				{
+					std::memmove(s_Data.SortKeys.data() + keyCount, builder.m_SortKeys, builder.m_SortCount * sizeof(uint64_t));
+					std::memmove(s_Data.SortValues.data() + keyCount, builder.m_SortValues, builder.m_SortCount * sizeof(uint32_t));
+				}
+				keyCount += builder.m_SortCount;
+			}
+			s_Data.SortKeys.resize(keyCount);
+			s_Data.SortValues.resize(keyCount);
+			return;
+		}
 
-		if (data.Texture != nullptr)
+		// Builders that filled their slice run straight into the next one, so those share a draw
+		auto drawSlices = [quads](bool circle)
 		{
-			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
+			uint32_t runBegin = 0, runEnd = 0;
+			for (const BatchBuilder2D& builder : s_Data.Builders)
 			{
-				if (*s_Data.TextureSlots[i].get() == *data.Texture.get())
+				uint32_t used = circle ? builder.m_CircleCount : builder.m_QuadCount;
+				if (used == 0)
+					continue;
+
+				// Quad and circle slices start at the same index
+				uint32_t sliceBegin = (uint32_t)(builder.m_Quads - quads);
+				if (sliceBegin != runEnd)
 				{
-					textureIndex = (float)i;
-					break;
+					if (runEnd != runBegin)
+					{
+						s_Data.Cmd->DrawIndexed(6, runEnd - runBegin, 0, 0, runBegin);
+						s_Data.Stats.DrawCalls++;
+					}
+					runBegin = sliceBegin;
 				}
+				runEnd = sliceBegin + used;
 			}
 
-			if (textureIndex == 0.0f)
+			if (runEnd != runBegin)
 			{
-				textureIndex = (float)s_Data.TextureSlotIndex;
-				s_Data.TextureSlots[s_Data.TextureSlotIndex] = data.Texture;
-				s_Data.TextureSlotIndex++;
+				s_Data.Cmd->DrawIndexed(6, runEnd - runBegin, 0, 0, runBegin);
+				s_Data.Stats.DrawCalls++;
 			}
+		};
 
+		uint32_t quadUsed = 0, circleUsed = 0;
+		for (const BatchBuilder2D& builder : s_Data.Builders)
+		{
+			if (builder.m_QuadCount)
+				quadUsed = (uint32_t)(builder.m_Quads - quads) + builder.m_QuadCount;
+			if (builder.m_CircleCount)
+				circleUsed = (uint32_t)(builder.m_Circles - circles) + builder.m_CircleCount;
 		}
 
-		for (int i = 0; i < 4; i++)
+		// Most recent allocation first, Trim only gives back the tail of the frame's cursor
+		s_Data.CircleInstanceBuffer->Trim(circleAllocation, circleUsed * sizeof(CircleInstance));
+		s_Data.QuadInstanceBuffer->Trim(quadAllocation, quadUsed * sizeof(QuadInstance));
+		s_Data.Stats.InstanceBytes += (quadCount * sizeof(QuadInstance)) + (circleCount * sizeof(CircleInstance));
+
+		if (quadCount != 0)
 		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->TexCoord = s_Data.QuadTexCoords[i];
-			s_Data.QuadVertexBufferPtr->Color = data.Color;
-			s_Data.QuadVertexBufferPtr->TexIndex = (int)textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = data.TilingFactor;
-			s_Data.QuadVertexBufferPtr->InstanceID = data.InstanceID;
-			s_Data.QuadVertexBufferPtr++;
+			s_Data.Cmd->BindPipeline(s_Data.QuadInstancedPipeline);
+			s_Data.Cmd->BindVertexBuffer(s_Data.QuadInstanceBuffer, quadAllocation);
+			drawSlices(false);
 		}
 
-		s_Data.QuadIndexCount += 6;
-		s_Data.Stats.QuadCount++;
+		if (circleCount != 0)
+		{
+			s_Data.Cmd->BindPipeline(s_Data.CircleInstancedPipeline);
+			s_Data.Cmd->BindVertexBuffer(s_Data.CircleInstanceBuffer, circleAllocation);
+			drawSlices(true);
+		}
+
+		StartBatch();
+	}
+
+	void BatchBuilder2D::DrawQuad(const VertexQuadData& data, const glm::mat4& transform)
+	{
+		EC_CORE_ASSERT(m_QuadCount < m_Capacity, "Batch builder records at most one quad per index!");
+
+		QuadInstance& instance = m_Quads[m_QuadCount];
+		instance = MakeQuadInstance(data, transform, Renderer2D::GetTextureIndex(data.Texture));
+		if (!IntersectsView(instance.Transform))
+		{
+			m_CulledCount++;
+			return;
+		}
+
+		if (m_SortKeys)
+		{
+			m_SortKeys[m_SortCount] = MakeSortKey(data.SortLayer, instance.Transform.GetTranslation(), SortPipeline::Quad, instance.TexIndex, instance.InstanceID);
+			m_SortValues[m_SortCount] = m_QuadBase + m_QuadCount;
+			m_SortCount++;
+		}
+		m_QuadCount++;
+	}
+
+	void BatchBuilder2D::DrawCircle(const VertexCircleData& data, const glm::mat4& transform)
+	{
+		EC_CORE_ASSERT(m_CircleCount < m_Capacity, "Batch builder records at most one circle per index!");
+
+		CircleInstance& instance = m_Circles[m_CircleCount];
+		instance = MakeCircleInstance(data, transform);
+		if (!IntersectsView(instance.Transform))
+		{
+			m_CulledCount++;
+			return;
+		}
+
+		if (m_SortKeys)
+		{
+			m_SortKeys[m_SortCount] = MakeSortKey(data.SortLayer, instance.Transform.GetTranslation(), SortPipeline::Circle, 0, instance.InstanceID);
+			m_SortValues[m_SortCount] = (m_CircleBase + m_CircleCount) | SortedCircleBit;
+			m_SortCount++;
+		}
+		m_CircleCount++;
 	}
 
 	void Renderer2D::DrawCircle(const VertexCircleData& data)
 	{
 		EC_PROFILE_FUNCTION();
+		if (!s_Data.UseInstancing && !s_Data.UseSorting)
+		{
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), data.Position)
+				* glm::scale(glm::mat4(1.0f), { data.Size.x, data.Size.y, 1.0f });
+
+			DrawCircle(data, transform);
+			return;
+		}
+
+		CircleInstance instance;
+		instance.Transform = ToInstanceTransform({ data.Size.x, 0.0f, 0.0f, data.Size.y }, data.Position);
+		if (!IsVisible(instance.Transform))
+			return;
+
+		instance.Color = PackColor(data.Color);
+		instance.OutlineThickness = data.OutlineThickness;
+		instance.Fade = data.Fade;
+		instance.InstanceID = data.InstanceID;
+		SubmitCircleInstance(instance, data.SortLayer);
+	}
+
+	void Renderer2D::DrawCircle(const VertexCircleData& data, const glm::mat4& transform)
+	{
+		EC_PROFILE_FUNCTION();
+		if (s_Data.UseInstancing || s_Data.UseSorting)
+		{
+			CircleInstance instance = MakeCircleInstance(data, transform);
+			if (IsVisible(instance.Transform))
+				SubmitCircleInstance(instance, data.SortLayer);
+			return;
+		}
+
+		if (!IsVisible(ToInstanceTransform(transform)))
+			return;
+
 		if (s_Data.CircleIndexCount >= s_Data.MaxIndices)
 			FlushAndReset();
 
-		glm::mat4 transform = glm::translate(glm::mat4(1.0f), data.Position)
-			* glm::scale(glm::mat4(1.0f), { data.Size.x, data.Size.y, 1.0f });
+		uint32_t color = PackColor(data.Color);
+		uint32_t outlineFade = glm::packUnorm2x16(glm::vec2(data.OutlineThickness, data.Fade));
 
 		for (int i = 0; i < 4; i++)
 		{
 			s_Data.CircleVertexBufferPtr->WorldPosition = transform * s_Data.QuadVertexPositions[i];
-			s_Data.CircleVertexBufferPtr->LocalPosition = s_Data.QuadVertexPositions[i] * 2.0f;
-			s_Data.CircleVertexBufferPtr->Color = data.Color;
-			s_Data.CircleVertexBufferPtr->OutlineThickness = data.OutlineThickness;
-			s_Data.CircleVertexBufferPtr->Fade = data.Fade;
+			s_Data.CircleVertexBufferPtr->Color = color;
+			s_Data.CircleVertexBufferPtr->OutlineFade = outlineFade;
 			s_Data.CircleVertexBufferPtr->InstanceID = data.InstanceID;
+			s_Data.CircleVertexBufferPtr->Corner = (uint8_t)i;
 			s_Data.CircleVertexBufferPtr++;
 		}
 
@@ -392,30 +1035,116 @@ namespace Echo
 		s_Data.Stats.CircleCount++;
 	}
 
-	void Renderer2D::DrawCircle(const VertexCircleData& data, const glm::mat4& transform)
+
+	void Renderer2D::SubmitQuadInstance(const QuadInstance& instance, uint8_t sortLayer)
 	{
-		EC_PROFILE_FUNCTION();
-		if (s_Data.CircleIndexCount >= s_Data.MaxIndices)
-			FlushAndReset();
+		s_Data.Stats.QuadCount++;
+		s_Data.Stats.InstancedQuadCount++;
 
-		for (int i = 0; i < 4; i++)
+		if (s_Data.UseSorting)
 		{
-			s_Data.CircleVertexBufferPtr->WorldPosition = transform * s_Data.QuadVertexPositions[i];
-			s_Data.CircleVertexBufferPtr->LocalPosition = s_Data.QuadVertexPositions[i] * 2.0f;
-			s_Data.CircleVertexBufferPtr->Color = data.Color;
-			s_Data.CircleVertexBufferPtr->OutlineThickness = data.OutlineThickness;
-			s_Data.CircleVertexBufferPtr->Fade = data.Fade;
-			s_Data.CircleVertexBufferPtr->InstanceID = data.InstanceID;
-			s_Data.CircleVertexBufferPtr++;
+			s_Data.SortKeys.push_back(MakeSortKey(sortLayer, instance.Transform.GetTranslation(), SortPipeline::Quad, instance.TexIndex, instance.InstanceID));
+			s_Data.SortValues.push_back((uint32_t)s_Data.SortedQuads.size());
+			s_Data.SortedQuads.push_back(instance);
+			return;
 		}
 
-		s_Data.CircleIndexCount += 6;
+		if (s_Data.QuadInstanceCount >= s_Data.MaxQuads)
+			FlushAndReset();
+
+		s_Data.QuadInstanceBufferBase[s_Data.QuadInstanceCount++] = instance;
+	}
+
+	void Renderer2D::SubmitCircleInstance(const CircleInstance& instance, uint8_t sortLayer)
+	{
 		s_Data.Stats.CircleCount++;
+		s_Data.Stats.InstancedCircleCount++;
+
+		if (s_Data.UseSorting)
+		{
+			s_Data.SortKeys.push_back(MakeSortKey(sortLayer, instance.Transform.GetTranslation(), SortPipeline::Circle, 0, instance.InstanceID));
+			s_Data.SortValues.push_back((uint32_t)s_Data.SortedCircles.size() | SortedCircleBit);
+			s_Data.SortedCircles.push_back(instance);
+			return;
+		}
+
+		if (s_Data.CircleInstanceCount >= s_Data.MaxQuads)
+			FlushAndReset();
+
+		s_Data.CircleInstanceBufferBase[s_Data.CircleInstanceCount++] = instance;
 	}
 
+	void Renderer2D::FlushSorted()
+	{
+		EC_PROFILE_FUNCTION();
+		if (s_Data.SortKeys.empty())
+			return;
+
+		RadixSort::Sort(s_Data.SortKeys, s_Data.SortValues, s_Data.KeyLayout.GetTotalBits());
+		s_Data.Stats.SortedCount += (uint32_t)s_Data.SortKeys.size();
+
+		// Every run of one primitive type is copied into the batch's region and drawn on its own,
+		// so the draws follow the key order exactly
+		uint32_t count = (uint32_t)s_Data.SortValues.size();
+		uint32_t runBegin = 0;
+		while (runBegin < count)
+		{
+			bool circle = (s_Data.SortValues[runBegin] & SortedCircleBit) != 0;
+			uint32_t runEnd = runBegin + 1;
+			while (runEnd < count && ((s_Data.SortValues[runEnd] & SortedCircleBit) != 0) == circle)
+			{
+				runEnd++;
+			}
+
+			while (runBegin < runEnd)
+			{
+				uint32_t& instanceCount = circle ? s_Data.CircleInstanceCount : s_Data.QuadInstanceCount;
+				if (instanceCount >= s_Data.MaxQuads)
+					FlushAndReset();
+
+				uint32_t first = instanceCount;
+				uint32_t runCount = std::min(runEnd - runBegin, s_Data.MaxQuads - first);
+				for (uint32_t i = 0; i < runCount; i++)
+				{
+					uint32_t index = s_Data.SortValues[runBegin + i] & ~SortedCircleBit;
+					if (circle)
+						s_Data.CircleInstanceBufferBase[first + i] = s_Data.SortedCircles[index];
+					else
+						s_Data.QuadInstanceBufferBase[first + i] = s_Data.SortedQuads[index];
+				}
+				instanceCount += runCount;
+
+				if (circle)
+				{
+					s_Data.Cmd->BindPipeline(s_Data.CircleInstancedPipeline);
+					s_Data.Cmd->BindVertexBuffer(s_Data.CircleInstanceBuffer, s_Data.CircleInstanceAllocation);
+					s_Data.CircleInstanceDrawn = instanceCount;
+				}
+				else
+				{
+					s_Data.Cmd->BindPipeline(s_Data.QuadInstancedPipeline);
+					s_Data.Cmd->BindVertexBuffer(s_Data.QuadInstanceBuffer, s_Data.QuadInstanceAllocation);
+					s_Data.QuadInstanceDrawn = instanceCount;
+				}
+				s_Data.Cmd->DrawIndexed(6, runCount, 0, 0, first);
+				s_Data.Stats.DrawCalls++;
+
+				runBegin += runCount;
+			}
+		}
+
+		s_Data.SortKeys.clear();
+		s_Data.SortValues.clear();
+		s_Data.SortedQuads.clear();
+		s_Data.SortedCircles.clear();
+	}
 
 	void Renderer2D::DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color /*= { 1.0f, 1.0f, 1.0f, 1.0f, }*/)
 	{
+		// Writes go straight to mapped GPU memory, never run past the frame's region
+		if (s_Data.LineCount + 2 > s_Data.MaxVertices)
+			FlushAndReset();
+
 		s_Data.LineVertexBufferPtr->Position = p0;
 		s_Data.LineVertexBufferPtr->Color = color;
 		s_Data.LineVertexBufferPtr++;
@@ -460,35 +1189,60 @@ namespace Echo
 	void Renderer2D::Flush()
 	{
 		EC_PROFILE_FUNCTION();
+		// Everything is already in GPU visible memory, only the unused tails go back
+		uint32_t quadDataSize = (uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase;
+		uint32_t circleDataSize = (uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase;
+		uint32_t lineDataSize = (uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase;
+		uint32_t quadInstanceSize = s_Data.QuadInstanceCount * sizeof(QuadInstance);
+		uint32_t circleInstanceSize = s_Data.CircleInstanceCount * sizeof(CircleInstance);
+
+		s_Data.QuadVertexBuffer->Trim(s_Data.QuadVertexAllocation, quadDataSize);
+		s_Data.CircleVertexBuffer->Trim(s_Data.CircleVertexAllocation, circleDataSize);
+		s_Data.LineVertexBuffer->Trim(s_Data.LineVertexAllocation, lineDataSize);
+		s_Data.QuadInstanceBuffer->Trim(s_Data.QuadInstanceAllocation, quadInstanceSize);
+		s_Data.CircleInstanceBuffer->Trim(s_Data.CircleInstanceAllocation, circleInstanceSize);
+
+		s_Data.Stats.VertexBytes += quadDataSize + circleDataSize;
+		s_Data.Stats.InstanceBytes += quadInstanceSize + circleInstanceSize;
 
 		if (s_Data.QuadIndexCount != 0)
 		{
 			s_Data.Cmd->BindPipeline(s_Data.QuadPipeline);
-			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
-			{
-				if (s_Data.TextureSlots[i] != nullptr)
-				{
-					s_Data.QuadPipeline->BindResource(1, 0, s_Data.TextureSlots[i], i);
-				}
-			}
-			s_Data.Cmd->BindVertexBuffer(s_Data.QuadVertexBuffer);
+			s_Data.Cmd->BindVertexBuffer(s_Data.QuadVertexBuffer, s_Data.QuadVertexAllocation);
 			s_Data.Cmd->DrawIndexed(s_Data.QuadIndexCount, 1, 0, 0, 0);
 			s_Data.Stats.DrawCalls++;
 		}
 
+		if (s_Data.QuadInstanceCount != s_Data.QuadInstanceDrawn)
+		{
+			s_Data.Cmd->BindPipeline(s_Data.QuadInstancedPipeline);
+			// The first 6 indices describe one quad, SV_VertexID picks the corner
+			s_Data.Cmd->BindVertexBuffer(s_Data.QuadInstanceBuffer, s_Data.QuadInstanceAllocation);
+			s_Data.Cmd->DrawIndexed(6, s_Data.QuadInstanceCount - s_Data.QuadInstanceDrawn, 0, 0, s_Data.QuadInstanceDrawn);
+			s_Data.Stats.DrawCalls++;
+		}
+
 		if (s_Data.CircleIndexCount != 0)
 		{
 			s_Data.Cmd->BindPipeline(s_Data.CirclePipeline);
-			s_Data.Cmd->BindVertexBuffer(s_Data.CircleVertexBuffer);
+			s_Data.Cmd->BindVertexBuffer(s_Data.CircleVertexBuffer, s_Data.CircleVertexAllocation);
 			s_Data.Cmd->DrawIndexed(s_Data.CircleIndexCount, 1, 0, 0, 0);
 			s_Data.Stats.DrawCalls++;
 		}
 
+		if (s_Data.CircleInstanceCount != s_Data.CircleInstanceDrawn)
+		{
+			s_Data.Cmd->BindPipeline(s_Data.CircleInstancedPipeline);
+			s_Data.Cmd->BindVertexBuffer(s_Data.CircleInstanceBuffer, s_Data.CircleInstanceAllocation);
+			s_Data.Cmd->DrawIndexed(6, s_Data.CircleInstanceCount - s_Data.CircleInstanceDrawn, 0, 0, s_Data.CircleInstanceDrawn);
+			s_Data.Stats.DrawCalls++;
+		}
+
 		if (s_Data.LineCount != 0)
 		{
 			s_Data.Cmd->SetLineWidth(2.0f);
 			s_Data.Cmd->BindPipeline(s_Data.LinePipeline);
-			s_Data.Cmd->BindVertexBuffer(s_Data.LineVertexBuffer);
+			s_Data.Cmd->BindVertexBuffer(s_Data.LineVertexBuffer, s_Data.LineVertexAllocation);
 			s_Data.Cmd->Draw(s_Data.LineCount, 1, 0, 0);
 			s_Data.Stats.DrawCalls++;
 		}
@@ -497,23 +1251,294 @@ namespace Echo
 	void Renderer2D::FlushAndReset()
 	{
 		EC_PROFILE_FUNCTION();
-		EndScene();
+		Flush();
+		StartBatch();
+	}
 
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
-		s_Data.QuadIndexCount = 0;
+	BatchStressResult Renderer2D::StressTestBatches(uint32_t quadCount)
+	{
+		EC_PROFILE_FUNCTION();
+		BatchStressResult result;
+		result.QuadCount = quadCount;
+
+		// The camera uniform isn't touched, a scene recorded earlier this frame still executes with its own
+		CommandList* previousCmd = s_Data.Cmd;
+		Statistics previousStats = s_Data.Stats;
+		bool previousInstancing = s_Data.UseInstancing, previousSorting = s_Data.UseSorting, previousCulling = s_Data.UseCulling;
+		// Streaming blocks are never shrunk, a hundred megabytes of test quads would stay with the frame slot
+		Ref<StreamingVertexBuffer> previousQuadBuffer = s_Data.QuadVertexBuffer;
+		Ref<StreamingVertexBuffer> quadBuffer = StreamingVertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
+
+		CommandList cmd;
+		s_Data.Cmd = &cmd;
+		s_Data.QuadVertexBuffer = quadBuffer;
+		s_Data.UseInstancing = false;
+		s_Data.UseSorting = false;
+		s_Data.UseCulling = false;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		StartBatch();
+		for (uint32_t i = 0; i < quadCount; i++)
+		{
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), { (float)(i % 1024), (float)(i / 1024), 0.0f });
+			DrawQuad({ .InstanceID = (int)i }, transform);
+		}
+		Flush();
+		auto end = std::chrono::high_resolution_clock::now();
+		result.Milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+		// Allocations within a block are handed out linearly, a batch must start past the end of every earlier one
+		std::unordered_map<uint32_t, uint64_t> blockEnds;
+		const BindStreamingVertexBufferPacket* bound = nullptr;
+		uint32_t nextQuad = 0;
+		cmd.GetCommands().ForEach([&](const CommandHeader& header)
+		{
+			if (header.Type == CommandType::BindStreamingVertexBuffer)
+			{
+				bound = &CommandStream::Decode<BindStreamingVertexBufferPacket>(header);
+				return;
+			}
 
-		s_Data.TextureSlotIndex = 1;
+			if (header.Type != CommandType::DrawIndexed || !bound || bound->Resource != quadBuffer.get())
+				return;
 
-		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
-		s_Data.CircleIndexCount = 0;
+			const DrawIndexedPacket& draw = CommandStream::Decode<DrawIndexedPacket>(header);
+			const StreamingAllocation& allocation = bound->Allocation;
+			uint32_t batchQuads = draw.IndexCount / 6;
+			result.BatchCount++;
 
-		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
-		s_Data.LineCount = 0;
+			bool valid = draw.IndexCount % 6 == 0 && draw.IndexCount <= s_Data.MaxIndices
+				&& allocation.Size >= batchQuads * 4 * sizeof(QuadVertex);
+
+			auto [blockEnd, inserted] = blockEnds.try_emplace(allocation.Block, 0);
+			valid &= allocation.Offset >= blockEnd->second;
+			blockEnd->second = std::max(blockEnd->second, allocation.Offset + allocation.Size);
+
+			// Read back after the whole scene was recorded, a later batch reusing the region would show here
+			const QuadVertex* vertices = (const QuadVertex*)allocation.Data;
+			for (uint32_t quad = 0; valid && quad < batchQuads; quad++)
+			{
+				for (uint32_t corner = 0; corner < 4; corner++)
+				{
+					valid &= vertices[quad * 4 + corner].InstanceID == (int)(nextQuad + quad);
+				}
+			}
+
+			nextQuad += batchQuads;
+			if (!valid)
+				result.FailedBatches++;
+		});
+
+		// Every quad has to be drawn exactly once
+		if (nextQuad != quadCount)
+			result.FailedBatches++;
+
+		if (result.Passed())
+			EC_CORE_INFO("Renderer2D stress test passed: {0} quads in {1} batches", quadCount, result.BatchCount);
+		else
+			EC_CORE_ERROR("Renderer2D stress test failed: {0} of {1} batches wrong, {2} of {3} quads drawn", result.FailedBatches, result.BatchCount, nextQuad, quadCount);
+
+		s_Data.Cmd = previousCmd;
+		s_Data.Stats = previousStats;
+		s_Data.UseInstancing = previousInstancing;
+		s_Data.UseSorting = previousSorting;
+		s_Data.UseCulling = previousCulling;
+
+		// Nothing may write through the last test batch once its buffer is gone, the next BeginScene starts a fresh one
+		s_Data.QuadVertexBuffer = previousQuadBuffer;
+		s_Data.QuadVertexAllocation = {};
+		s_Data.QuadVertexBufferBase = nullptr;
+		s_Data.QuadVertexBufferPtr = nullptr;
+		return result;
+	}
+
+	void Renderer2D::SetInstancingEnabled(bool enabled)
+	{
+		s_Data.InstancingEnabled = enabled;
+	}
+
+	bool Renderer2D::IsInstancingEnabled()
+	{
+		return s_Data.InstancingEnabled;
+	}
+
+	RetainedQuadBatch::RetainedQuadBatch(uint32_t capacity)
+		: m_Capacity(std::max(capacity, 1u))
+	{
+		m_Buffer = RetainedVertexBuffer::Create(m_Capacity * sizeof(QuadInstance));
+	}
+
+	RetainedQuadBatch::~RetainedQuadBatch() = default;
+
+	void RetainedQuadBatch::ReserveSlots()
+	{
+		if (m_CenterX.size() >= m_Capacity)
+			return;
+
+		m_CenterX.resize(m_Capacity);
+		m_CenterY.resize(m_Capacity);
+		m_CenterZ.resize(m_Capacity);
+		m_ExtentX.resize(m_Capacity);
+		m_ExtentY.resize(m_Capacity);
+		m_ExtentZ.resize(m_Capacity);
+		m_Instances.resize(m_Capacity);
+		m_SortLayers.resize(m_Capacity);
+	}
+
+	void RetainedQuadBatch::SetBounds(uint32_t slot, const InstanceTransform& transform)
+	{
+		glm::vec3 translation = transform.GetTranslation();
+		glm::vec3 extents = GetQuadExtents(transform);
+		m_CenterX[slot] = translation.x;
+		m_CenterY[slot] = translation.y;
+		m_CenterZ[slot] = translation.z;
+		m_ExtentX[slot] = extents.x;
+		m_ExtentY[slot] = extents.y;
+		m_ExtentZ[slot] = extents.z;
+	}
+
+	uint32_t RetainedQuadBatch::Add()
+	{
+		uint32_t slot;
+		if (!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			if (m_SlotCount == m_Capacity)
+			{
+				m_Capacity *= 2;
+				m_Buffer->Resize(m_Capacity * sizeof(QuadInstance));
+			}
+			slot = m_SlotCount++;
+		}
+		return slot;
+	}
+
+	uint32_t RetainedQuadBatch::Add(const VertexQuadData& data, const glm::mat4& transform)
+	{
+		uint32_t slot = Add();
+		Update(slot, data, transform);
+		return slot;
+	}
+
+	void RetainedQuadBatch::Update(uint32_t slot, const VertexQuadData& data, const glm::mat4& transform)
+	{
+		EC_CORE_ASSERT(slot < m_SlotCount, "Invalid retained quad slot!");
+
+		QuadInstance instance = MakeQuadInstance(data, transform, Renderer2D::GetTextureIndex(data.Texture));
+		ReserveSlots();
+		SetBounds(slot, instance.Transform);
+		m_Instances[slot] = instance;
+		m_SortLayers[slot] = data.SortLayer;
+		m_Buffer->Write(slot * sizeof(QuadInstance), &instance, sizeof(QuadInstance));
+		s_Data.Stats.RetainedBytes += sizeof(QuadInstance);
+	}
+
+	void RetainedQuadBatch::UpdateParallel(std::span<const uint32_t> slots, uint32_t grainSize, const RetainedFillFunction& fill)
+	{
+		EC_PROFILE_FUNCTION();
+		if (slots.empty())
+			return;
+
+		// Every job only touches the entries of its own slots
+		ReserveSlots();
+		JobSystem::ParallelFor((uint32_t)slots.size(), grainSize, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				uint32_t slot = slots[i];
+				EC_CORE_ASSERT(slot < m_SlotCount, "Invalid retained quad slot!");
+
+				VertexQuadData data;
+				glm::mat4 transform(1.0f);
+				fill(i, data, transform);
+
+				QuadInstance instance = MakeQuadInstance(data, transform, Renderer2D::GetTextureIndex(data.Texture));
+				SetBounds(slot, instance.Transform);
+				m_Instances[slot] = instance;
+				m_SortLayers[slot] = data.SortLayer;
+			}
+		});
+
+		// The buffer tracks its pending ranges unsynchronized, so the copies in stay on this thread
+		for (uint32_t slot : slots)
+		{
+			m_Buffer->Write(slot * sizeof(QuadInstance), &m_Instances[slot], sizeof(QuadInstance));
+		}
+		s_Data.Stats.RetainedBytes += slots.size() * sizeof(QuadInstance);
+	}
+
+	void RetainedQuadBatch::Remove(uint32_t slot)
+	{
+		EC_CORE_ASSERT(slot < m_SlotCount, "Invalid retained quad slot!");
+		ReserveSlots();
+
+		// A zero transform collapses the quad to a point, nothing gets rasterized
+		QuadInstance instance{};
+		m_Instances[slot] = instance;
+		m_Buffer->Write(slot * sizeof(QuadInstance), &instance, sizeof(QuadInstance));
+		s_Data.Stats.RetainedBytes += sizeof(QuadInstance);
+
+		// Negative extents never pass the cull test, so the slot doesn't keep a run of visible slots open
+		m_ExtentX[slot] = -std::numeric_limits<float>::max();
+		m_ExtentY[slot] = -std::numeric_limits<float>::max();
+		m_ExtentZ[slot] = 0.0f;
+
+		m_FreeSlots.push_back(slot);
+	}
+
+	void RetainedQuadBatch::Clear()
+	{
+		m_FreeSlots.clear();
+		m_SlotCount = 0;
+	}
+
+	void Renderer2D::SetCullingEnabled(bool enabled)
+	{
+		s_Data.CullingEnabled = enabled;
+	}
+
+	bool Renderer2D::IsCullingEnabled()
+	{
+		return s_Data.CullingEnabled;
+	}
+
+	void Renderer2D::SetSortingEnabled(bool enabled)
+	{
+		s_Data.SortingEnabled = enabled;
+	}
+
+	bool Renderer2D::IsSortingEnabled()
+	{
+		return s_Data.SortingEnabled;
+	}
+
+	void Renderer2D::SetSortKeyLayout(const SortKeyLayout& layout)
+	{
+		EC_CORE_ASSERT(layout.GetTotalBits() <= 64, "Sort key layout doesn't fit in 64 bits!");
+		EC_CORE_ASSERT(layout.Bits[(size_t)SortKeyField::Depth] <= 32, "Sort key depth is at most 32 bits!");
+		s_Data.KeyLayout = layout;
+	}
+
+	const SortKeyLayout& Renderer2D::GetSortKeyLayout()
+	{
+		return s_Data.KeyLayout;
+	}
+
+	SIMDLevel Renderer2D::GetSIMDLevel()
+	{
+		return s_Data.KernelLevel;
 	}
 
 	Statistics Renderer2D::GetStats()
 	{
-		return s_Data.Stats;
+		Statistics stats = s_Data.Stats;
+		stats.QuadVertexSize = sizeof(QuadVertex);
+		stats.CircleVertexSize = sizeof(CircleVertex);
+		return stats;
 	}
 
 	void Renderer2D::ResetStats()
@@ -534,12 +1559,15 @@ namespace Echo
 		s_Data.QuadPipeline.reset();
 		s_Data.CirclePipeline.reset();
 		s_Data.LinePipeline.reset();
+		s_Data.QuadInstanceBuffer.reset();
+		s_Data.CircleInstanceBuffer.reset();
+		s_Data.QuadInstancedShader.reset();
+		s_Data.CircleInstancedShader.reset();
+		s_Data.QuadInstancedPipeline.reset();
+		s_Data.CircleInstancedPipeline.reset();
 		s_Data.CamUniformBuffer.reset();
-		s_Data.TextureSlots[0]->Destroy();
-
-		delete[] s_Data.QuadVertexBufferBase;
-		delete[] s_Data.CircleVertexBufferBase;
-		delete[] s_Data.LineVertexBufferBase;
+		s_Data.WhiteTexture->Destroy();
+		s_Data.WhiteTexture.reset();
 	}
 
 }
\ No newline at end of file
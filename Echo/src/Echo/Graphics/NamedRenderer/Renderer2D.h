@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/CommandList.h"
+#include "Graphics/Primitives/Buffer.h"
 
 #include "Graphics/Camera.h"
 #include "Graphics/EditorCamera.h"
@@ -8,8 +9,13 @@
 
 #include "AssetManager/AssetRegistry.h"
 
+#include "Core/CPUInfo.h"
+
 #include <glm/glm.hpp>
 
+#include <span>
+#include <functional>
+
 namespace Echo 
 {
 
@@ -23,6 +29,9 @@ namespace Echo
 		glm::vec4 Color{1.0f, 1.0f, 1.0f, 1.0f};
 		Ref<Texture2D> Texture = nullptr;
 		float TilingFactor = 1.0f;
+
+		// Most significant part of the sort key, higher layers draw on top
+		uint8_t SortLayer = 0;
 	};
 
 	struct VertexCircleData 
@@ -34,6 +43,33 @@ namespace Echo
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
 		float OutlineThickness;
 		float Fade;
+
+		uint8_t SortLayer = 0;
+	};
+
+	enum class SortKeyField : uint8_t
+	{
+		Layer = 0,
+		Depth,
+		Pipeline,
+		Texture,
+		Entity,
+		Count
+	};
+
+	// How sorted submissions pack their 64 bit key. Fields go from most to least significant in Order,
+	// each cut to its width in Bits (indexed by field), a width of 0 leaves the field out
+	struct SortKeyLayout
+	{
+		SortKeyField Order[(size_t)SortKeyField::Count] = { SortKeyField::Layer, SortKeyField::Depth, SortKeyField::Pipeline, SortKeyField::Texture, SortKeyField::Entity };
+		uint8_t Bits[(size_t)SortKeyField::Count] = { 8, 24, 2, 14, 16 };
+		// Farthest first, which blending needs. Depth is at most 32 bits
+		bool BackToFront = true;
+
+		uint32_t GetTotalBits() const;
+
+		// State first and front to back, fewest draw calls for content that doesn't blend
+		static SortKeyLayout Opaque();
 	};
 
 	struct Statistics
@@ -42,6 +78,28 @@ namespace Echo
 		uint32_t QuadCount = 0;
 		uint32_t CircleCount = 0;
 
+		// Part of QuadCount/CircleCount drawn through the instanced path
+		uint32_t InstancedQuadCount = 0;
+		uint32_t InstancedCircleCount = 0;
+
+		// Part of QuadCount drawn from retained batches
+		uint32_t RetainedQuadCount = 0;
+		// Quads and circles that went through the sort
+		uint32_t SortedCount = 0;
+		// Quads and circles tested against the camera frustum, the culled ones were never uploaded or drawn
+		uint32_t CulledCount = 0;
+		uint32_t VisibleCount = 0;
+
+		// Quad and circle data uploaded by each path
+		uint64_t VertexBytes = 0;
+		uint64_t InstanceBytes = 0;
+		// Retained quad records written, only changed quads cost anything here
+		uint64_t RetainedBytes = 0;
+
+		// Bytes per vertex of the batched (non-instanced) paths, four per quad or circle
+		uint32_t QuadVertexSize = 0;
+		uint32_t CircleVertexSize = 0;
+
 		uint32_t GetTotalQuadVertexCount() { return QuadCount * 4; }
 		uint32_t GetTotalQuadIndexCount() { return QuadCount * 6; }
 
@@ -49,6 +107,100 @@ namespace Echo
 		uint32_t GetTotalCircleIndexCount() { return CircleCount * 6; }
 	};
 
+	// Outcome of Renderer2D::StressTestBatches
+	struct BatchStressResult
+	{
+		uint32_t QuadCount = 0;
+		uint32_t BatchCount = 0;
+		// Batches whose region overlapped an earlier one or whose vertices weren't their own quads
+		uint32_t FailedBatches = 0;
+		double Milliseconds = 0.0;
+
+		bool Passed() const { return BatchCount != 0 && FailedBatches == 0; }
+	};
+
+	struct InstanceTransform;
+	struct QuadInstance;
+	struct CircleInstance;
+
+	using RetainedFillFunction = std::function<void(uint32_t index, VertexQuadData& data, glm::mat4& transform)>;
+
+	// Quads that stay in GPU visible memory across frames, for content that rarely changes. Every quad
+	// owns a slot and only slots that are added, updated or removed get uploaded again. The batch may be
+	// drawn several times a frame, but not changed in between, the frame's GPU copy is patched in place.
+	// A CPU copy of every slot is kept too, for scenes that sort
+	class RetainedQuadBatch
+	{
+	public:
+		RetainedQuadBatch(uint32_t capacity = 1024);
+		~RetainedQuadBatch();
+
+		// Takes a slot without writing it, it has to be filled by Update or UpdateParallel before the next draw
+		uint32_t Add();
+		uint32_t Add(const VertexQuadData& data, const glm::mat4& transform);
+		void Update(uint32_t slot, const VertexQuadData& data, const glm::mat4& transform);
+		// Same as Update for every slot in slots, with the instances built across the job system. fill runs on
+		// any thread, once per index, and sets the data and transform for slots[index]. Slots must be distinct
+		void UpdateParallel(std::span<const uint32_t> slots, uint32_t grainSize, const RetainedFillFunction& fill);
+		void Remove(uint32_t slot);
+		// Drops every slot, the GPU copies are reused
+		void Clear();
+
+		uint32_t GetQuadCount() const { return m_SlotCount - (uint32_t)m_FreeSlots.size(); }
+		// Removed slots below the highest one in use are still drawn, as empty quads
+		uint32_t GetSlotCount() const { return m_SlotCount; }
+	private:
+		// Sizes the per slot CPU arrays to the capacity, so slots can be filled from several threads
+		void ReserveSlots();
+		void SetBounds(uint32_t slot, const InstanceTransform& transform);
+	private:
+		Ref<RetainedVertexBuffer> m_Buffer;
+		std::vector<uint32_t> m_FreeSlots;
+		uint32_t m_SlotCount = 0;
+		uint32_t m_Capacity;
+
+		// World space bounds of every slot, laid out for the SIMD cull kernel
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+		std::vector<uint8_t> m_Visible;
+
+		// What was last written to every slot, fed through the sort when sorting is on
+		std::vector<QuadInstance> m_Instances;
+		std::vector<uint8_t> m_SortLayers;
+
+		friend class Renderer2D;
+	};
+
+	// Records quads and circles from one job. Each builder owns a slice of the frame's instance memory
+	// (or of the sort arrays, when sorting), so builders never share anything while recording.
+	// Handed out by Renderer2D::DrawParallel, which merges them into the draw list afterwards
+	class BatchBuilder2D
+	{
+	public:
+		void DrawQuad(const VertexQuadData& data, const glm::mat4& transform);
+		void DrawCircle(const VertexCircleData& data, const glm::mat4& transform);
+	private:
+		QuadInstance* m_Quads = nullptr;
+		CircleInstance* m_Circles = nullptr;
+		// Per primitive type, one of each per index of the builder's range
+		uint32_t m_Capacity = 0;
+		uint32_t m_QuadCount = 0;
+		uint32_t m_CircleCount = 0;
+
+		// Sorted submissions only. The bases turn slice indices into SortedQuads/SortedCircles indices
+		uint64_t* m_SortKeys = nullptr;
+		uint32_t* m_SortValues = nullptr;
+		uint32_t m_SortCount = 0;
+		uint32_t m_QuadBase = 0;
+		uint32_t m_CircleBase = 0;
+
+		uint32_t m_CulledCount = 0;
+
+		friend class Renderer2D;
+	};
+
+	using ParallelRecordFunction = std::function<void(BatchBuilder2D& builder, uint32_t begin, uint32_t end)>;
+
 	class Renderer2D
 	{
 	public:
@@ -60,6 +212,15 @@ namespace Echo
 
 		static void DrawQuad(const VertexQuadData& data);
 		static void DrawQuad(const VertexQuadData& data, const glm::mat4& transform);
+		// Same result as DrawQuad for each element, with the transforms computed by the SIMD kernels
+		static void DrawQuads(std::span<const VertexQuadData> quads);
+		// Drawn instanced right away, ahead of whatever is still batched. When sorting, the visible slots
+		// are submitted into the frame's sort instead and drawn in key order with everything else
+		static void DrawRetained(const Ref<RetainedQuadBatch>& batch);
+		// Runs record for chunks of [0, count) across the job system, each chunk with a builder of its own.
+		// Every index may record at most one quad and one circle. Always goes through the instanced path;
+		// unsorted results are drawn right away, after anything submitted before, quads in index order then circles
+		static void DrawParallel(uint32_t count, uint32_t grainSize, const ParallelRecordFunction& record);
 
 		static void DrawCircle(const VertexCircleData& data);
 		static void DrawCircle(const VertexCircleData& data, const glm::mat4& transform);
@@ -69,12 +230,49 @@ namespace Echo
 		static void DrawRect(const glm::mat4& transform, const glm::vec4& color = { 1.0f, 1.0f, 1.0f, 1.0f, });
 
 		static void Flush();
+
+		// Quads and circles are sent as one record per instance and expanded by the vertex shader,
+		// instead of four vertices each. Takes effect on the next BeginScene
+		static void SetInstancingEnabled(bool enabled);
+		static bool IsInstancingEnabled();
+
+		// Quads and circles are collected with a sort key and drawn in key order at EndScene, always through
+		// the instanced path. Retained batches join the sort, lines don't. Off by default, a sorted frame costs
+		// every visible retained quad instead of only the changed ones. Takes effect on the next BeginScene
+		static void SetSortingEnabled(bool enabled);
+		static bool IsSortingEnabled();
+		static void SetSortKeyLayout(const SortKeyLayout& layout);
+		static const SortKeyLayout& GetSortKeyLayout();
+
+		// Quads and circles outside the camera's frustum are dropped at submission, retained batches
+		// only draw the runs of slots that are in view. Takes effect on the next BeginScene
+		static void SetCullingEnabled(bool enabled);
+		static bool IsCullingEnabled();
+
+		// Instruction set DrawQuads runs on, picked from the CPU at Init
+		static SIMDLevel GetSIMDLevel();
+
+		// Records quadCount quads through the batched vertex path into a throwaway command list, then walks
+		// the recorded draws and checks every batch has a region of its own that still holds exactly its
+		// quads. Nothing is submitted. Call outside BeginScene/EndScene; the quads go through a vertex buffer
+		// of their own, released afterwards so the frame's streaming buffers don't keep blocks that size
+		static BatchStressResult StressTestBatches(uint32_t quadCount = 1100000);
 		
 		static Statistics GetStats();
 		static void ResetStats();
 
 		static void Destroy();
 	private:
+		static void StartScene(CommandList& cmd, const glm::mat4& projView);
+		static void StartBatch();
+		static int GetTextureIndex(const Ref<Texture2D>& texture);
 		static void FlushAndReset();
+
+		static void SubmitQuadInstance(const QuadInstance& instance, uint8_t sortLayer);
+		static void SubmitCircleInstance(const CircleInstance& instance, uint8_t sortLayer);
+		static void FlushSorted();
+
+		friend class RetainedQuadBatch;
+		friend class BatchBuilder2D;
 	};
 }
\ No newline at end of file
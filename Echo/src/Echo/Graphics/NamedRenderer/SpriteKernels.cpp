@@ -0,0 +1,406 @@
+#include "pch.h"
+#include "SpriteKernels.h"
+
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define EC_SPRITE_KERNELS_X86 1
+	#include <immintrin.h>
+
+	// MSVC allows any intrinsic in any function, GCC and Clang need the target enabled per function
+	#ifdef _MSC_VER
+		#define EC_TARGET_AVX2
+	#else
+		#define EC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+namespace Echo
+{
+
+	// Renderer2D's quad corners in local space, see QuadVertexPositions
+	static constexpr float s_CornerOffsetX[4] = { -0.5f, 0.5f, 0.5f, -0.5f };
+	static constexpr float s_CornerOffsetY[4] = { -0.5f, -0.5f, 0.5f, 0.5f };
+
+	static void TransformScalarRange(const SpriteTransformInput& input, const SpriteTransformOutput& output, uint32_t begin)
+	{
+		bool corners = output.CornerX[0] != nullptr;
+		for (uint32_t i = begin; i < input.Count; i++)
+		{
+			float c = std::cos(input.Rotation[i]);
+			float s = std::sin(input.Rotation[i]);
+
+			float xx = c * input.SizeX[i];
+			float xy = s * input.SizeX[i];
+			float yx = -s * input.SizeY[i];
+			float yy = c * input.SizeY[i];
+
+			output.AxisXx[i] = xx;
+			output.AxisXy[i] = xy;
+			output.AxisYx[i] = yx;
+			output.AxisYy[i] = yy;
+
+			if (!corners)
+				continue;
+
+			for (int k = 0; k < 4; k++)
+			{
+				output.CornerX[k][i] = input.PositionX[i] + s_CornerOffsetX[k] * xx + s_CornerOffsetY[k] * yx;
+				output.CornerY[k][i] = input.PositionY[i] + s_CornerOffsetX[k] * xy + s_CornerOffsetY[k] * yy;
+			}
+		}
+	}
+
+	// Reference implementation, also finishes the tails of the vector kernels
+	static void TransformScalar(const SpriteTransformInput& input, const SpriteTransformOutput& output)
+	{
+		TransformScalarRange(input, output, 0);
+	}
+
+	static uint32_t CullScalarRange(const Frustum& frustum, const SpriteBoundsInput& input, uint8_t* visible, uint32_t begin)
+	{
+		uint32_t visibleCount = 0;
+		for (uint32_t i = begin; i < input.Count; i++)
+		{
+			bool inside = true;
+			for (const glm::vec4& plane : frustum.Planes)
+			{
+				float distance = plane.x * input.CenterX[i] + plane.y * input.CenterY[i] + plane.z * input.CenterZ[i] + plane.w;
+				float radius = std::abs(plane.x) * input.ExtentX[i] + std::abs(plane.y) * input.ExtentY[i];
+				if (input.ExtentZ)
+					radius += std::abs(plane.z) * input.ExtentZ[i];
+				inside &= distance + radius >= 0.0f;
+			}
+
+			visible[i] = inside ? 1 : 0;
+			visibleCount += inside ? 1 : 0;
+		}
+		return visibleCount;
+	}
+
+	static uint32_t CullScalar(const Frustum& frustum, const SpriteBoundsInput& input, uint8_t* visible)
+	{
+		return CullScalarRange(frustum, input, visible, 0);
+	}
+
+#ifdef EC_SPRITE_KERNELS_X86
+	// Cephes style sin/cos: reduce to [-pi/4, pi/4] by octant, then pick the sin or cos polynomial per lane
+	static constexpr float s_FourOverPi = 1.27323954473516f;
+	static constexpr float s_ReduceDP1 = -0.78515625f;
+	static constexpr float s_ReduceDP2 = -2.4187564849853515625e-4f;
+	static constexpr float s_ReduceDP3 = -3.77489497744594108e-8f;
+	static constexpr float s_CosCoef0 = 2.443315711809948e-5f;
+	static constexpr float s_CosCoef1 = -1.388731625493765e-3f;
+	static constexpr float s_CosCoef2 = 4.166664568298827e-2f;
+	static constexpr float s_SinCoef0 = -1.9515295891e-4f;
+	static constexpr float s_SinCoef1 = 8.3321608736e-3f;
+	static constexpr float s_SinCoef2 = -1.6666654611e-1f;
+
+	static inline void SinCosSSE2(__m128 x, __m128& sinOut, __m128& cosOut)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(s_FourOverPi)));
+		octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(octant);
+
+		__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29));
+		__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(s_ReduceDP1)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(s_ReduceDP2)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(s_ReduceDP3)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		__m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s_CosCoef0), z), _mm_set1_ps(s_CosCoef1));
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(s_CosCoef2));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+		cosPoly = _mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		cosPoly = _mm_add_ps(cosPoly, _mm_set1_ps(1.0f));
+
+		__m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s_SinCoef0), z), _mm_set1_ps(s_SinCoef1));
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(s_SinCoef2));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+		__m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, sinPoly), _mm_andnot_ps(polyMask, cosPoly));
+		__m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, cosPoly), _mm_andnot_ps(polyMask, sinPoly));
+		sinOut = _mm_xor_ps(sinValue, signSin);
+		cosOut = _mm_xor_ps(cosValue, signCos);
+	}
+
+	static void TransformSSE2(const SpriteTransformInput& input, const SpriteTransformOutput& output)
+	{
+		bool corners = output.CornerX[0] != nullptr;
+		uint32_t vectorCount = input.Count & ~3u;
+		for (uint32_t i = 0; i < vectorCount; i += 4)
+		{
+			__m128 s, c;
+			SinCosSSE2(_mm_loadu_ps(input.Rotation + i), s, c);
+
+			__m128 sizeX = _mm_loadu_ps(input.SizeX + i);
+			__m128 sizeY = _mm_loadu_ps(input.SizeY + i);
+			__m128 xx = _mm_mul_ps(c, sizeX);
+			__m128 xy = _mm_mul_ps(s, sizeX);
+			__m128 yx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(s, sizeY));
+			__m128 yy = _mm_mul_ps(c, sizeY);
+
+			_mm_storeu_ps(output.AxisXx + i, xx);
+			_mm_storeu_ps(output.AxisXy + i, xy);
+			_mm_storeu_ps(output.AxisYx + i, yx);
+			_mm_storeu_ps(output.AxisYy + i, yy);
+
+			if (!corners)
+				continue;
+
+			__m128 px = _mm_loadu_ps(input.PositionX + i);
+			__m128 py = _mm_loadu_ps(input.PositionY + i);
+			for (int k = 0; k < 4; k++)
+			{
+				__m128 ox = _mm_set1_ps(s_CornerOffsetX[k]);
+				__m128 oy = _mm_set1_ps(s_CornerOffsetY[k]);
+				_mm_storeu_ps(output.CornerX[k] + i, _mm_add_ps(px, _mm_add_ps(_mm_mul_ps(ox, xx), _mm_mul_ps(oy, yx))));
+				_mm_storeu_ps(output.CornerY[k] + i, _mm_add_ps(py, _mm_add_ps(_mm_mul_ps(ox, xy), _mm_mul_ps(oy, yy))));
+			}
+		}
+
+		TransformScalarRange(input, output, vectorCount);
+	}
+
+	// Lane masks to the 0/1 bytes of the visible array, bit i of the movemask result is lane i
+	static inline uint32_t StoreVisibleMask(int mask, uint32_t lanes, uint8_t* visible)
+	{
+		for (uint32_t lane = 0; lane < lanes; lane++)
+		{
+			visible[lane] = (mask >> lane) & 1;
+		}
+		return (uint32_t)std::popcount((uint32_t)mask);
+	}
+
+	static uint32_t CullSSE2(const Frustum& frustum, const SpriteBoundsInput& input, uint8_t* visible)
+	{
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		uint32_t visibleCount = 0;
+		uint32_t vectorCount = input.Count & ~3u;
+		for (uint32_t i = 0; i < vectorCount; i += 4)
+		{
+			__m128 cx = _mm_loadu_ps(input.CenterX + i);
+			__m128 cy = _mm_loadu_ps(input.CenterY + i);
+			__m128 cz = _mm_loadu_ps(input.CenterZ + i);
+			__m128 ex = _mm_loadu_ps(input.ExtentX + i);
+			__m128 ey = _mm_loadu_ps(input.ExtentY + i);
+			__m128 ez = input.ExtentZ ? _mm_loadu_ps(input.ExtentZ + i) : _mm_setzero_ps();
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (const glm::vec4& plane : frustum.Planes)
+			{
+				__m128 nx = _mm_set1_ps(plane.x);
+				__m128 ny = _mm_set1_ps(plane.y);
+				__m128 nz = _mm_set1_ps(plane.z);
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(plane.w)));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx, absMask), ex), _mm_mul_ps(_mm_and_ps(ny, absMask), ey)), _mm_mul_ps(_mm_and_ps(nz, absMask), ez));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+
+			visibleCount += StoreVisibleMask(_mm_movemask_ps(inside), 4, visible + i);
+		}
+
+		return visibleCount + CullScalarRange(frustum, input, visible, vectorCount);
+	}
+
+	EC_TARGET_AVX2 static inline void SinCosAVX2(__m256 x, __m256& sinOut, __m256& cosOut)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+		__m256 signSin = _mm256_and_ps(x, signMask);
+		x = _mm256_andnot_ps(signMask, x);
+
+		__m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(s_FourOverPi)));
+		octant = _mm256_and_si256(_mm256_add_epi32(octant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+		__m256 y = _mm256_cvtepi32_ps(octant);
+
+		__m256 swapSignSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(4)), 29));
+		__m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+		__m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+		signSin = _mm256_xor_ps(signSin, swapSignSin);
+
+		x = _mm256_fmadd_ps(y, _mm256_set1_ps(s_ReduceDP1), x);
+		x = _mm256_fmadd_ps(y, _mm256_set1_ps(s_ReduceDP2), x);
+		x = _mm256_fmadd_ps(y, _mm256_set1_ps(s_ReduceDP3), x);
+		__m256 z = _mm256_mul_ps(x, x);
+
+		__m256 cosPoly = _mm256_fmadd_ps(_mm256_set1_ps(s_CosCoef0), z, _mm256_set1_ps(s_CosCoef1));
+		cosPoly = _mm256_fmadd_ps(cosPoly, z, _mm256_set1_ps(s_CosCoef2));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+		cosPoly = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), cosPoly);
+		cosPoly = _mm256_add_ps(cosPoly, _mm256_set1_ps(1.0f));
+
+		__m256 sinPoly = _mm256_fmadd_ps(_mm256_set1_ps(s_SinCoef0), z, _mm256_set1_ps(s_SinCoef1));
+		sinPoly = _mm256_fmadd_ps(sinPoly, z, _mm256_set1_ps(s_SinCoef2));
+		sinPoly = _mm256_fmadd_ps(_mm256_mul_ps(sinPoly, z), x, x);
+
+		__m256 sinValue = _mm256_blendv_ps(cosPoly, sinPoly, polyMask);
+		__m256 cosValue = _mm256_blendv_ps(sinPoly, cosPoly, polyMask);
+		sinOut = _mm256_xor_ps(sinValue, signSin);
+		cosOut = _mm256_xor_ps(cosValue, signCos);
+	}
+
+	EC_TARGET_AVX2 static void TransformAVX2(const SpriteTransformInput& input, const SpriteTransformOutput& output)
+	{
+		bool corners = output.CornerX[0] != nullptr;
+		uint32_t vectorCount = input.Count & ~7u;
+		for (uint32_t i = 0; i < vectorCount; i += 8)
+		{
+			__m256 s, c;
+			SinCosAVX2(_mm256_loadu_ps(input.Rotation + i), s, c);
+
+			__m256 sizeX = _mm256_loadu_ps(input.SizeX + i);
+			__m256 sizeY = _mm256_loadu_ps(input.SizeY + i);
+			__m256 xx = _mm256_mul_ps(c, sizeX);
+			__m256 xy = _mm256_mul_ps(s, sizeX);
+			__m256 yx = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(s, sizeY));
+			__m256 yy = _mm256_mul_ps(c, sizeY);
+
+			_mm256_storeu_ps(output.AxisXx + i, xx);
+			_mm256_storeu_ps(output.AxisXy + i, xy);
+			_mm256_storeu_ps(output.AxisYx + i, yx);
+			_mm256_storeu_ps(output.AxisYy + i, yy);
+
+			if (!corners)
+				continue;
+
+			__m256 px = _mm256_loadu_ps(input.PositionX + i);
+			__m256 py = _mm256_loadu_ps(input.PositionY + i);
+			for (int k = 0; k < 4; k++)
+			{
+				__m256 ox = _mm256_set1_ps(s_CornerOffsetX[k]);
+				__m256 oy = _mm256_set1_ps(s_CornerOffsetY[k]);
+				_mm256_storeu_ps(output.CornerX[k] + i, _mm256_fmadd_ps(ox, xx, _mm256_fmadd_ps(oy, yx, px)));
+				_mm256_storeu_ps(output.CornerY[k] + i, _mm256_fmadd_ps(ox, xy, _mm256_fmadd_ps(oy, yy, py)));
+			}
+		}
+
+		TransformScalarRange(input, output, vectorCount);
+	}
+
+	EC_TARGET_AVX2 static uint32_t CullAVX2(const Frustum& frustum, const SpriteBoundsInput& input, uint8_t* visible)
+	{
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		uint32_t visibleCount = 0;
+		uint32_t vectorCount = input.Count & ~7u;
+		for (uint32_t i = 0; i < vectorCount; i += 8)
+		{
+			__m256 cx = _mm256_loadu_ps(input.CenterX + i);
+			__m256 cy = _mm256_loadu_ps(input.CenterY + i);
+			__m256 cz = _mm256_loadu_ps(input.CenterZ + i);
+			__m256 ex = _mm256_loadu_ps(input.ExtentX + i);
+			__m256 ey = _mm256_loadu_ps(input.ExtentY + i);
+			__m256 ez = input.ExtentZ ? _mm256_loadu_ps(input.ExtentZ + i) : _mm256_setzero_ps();
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (const glm::vec4& plane : frustum.Planes)
+			{
+				__m256 nx = _mm256_set1_ps(plane.x);
+				__m256 ny = _mm256_set1_ps(plane.y);
+				__m256 nz = _mm256_set1_ps(plane.z);
+				__m256 distance = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nz, cz, _mm256_set1_ps(plane.w))));
+				__m256 radius = _mm256_fmadd_ps(_mm256_and_ps(nx, absMask), ex, _mm256_fmadd_ps(_mm256_and_ps(ny, absMask), ey, _mm256_mul_ps(_mm256_and_ps(nz, absMask), ez)));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+
+			visibleCount += StoreVisibleMask(_mm256_movemask_ps(inside), 8, visible + i);
+		}
+
+		return visibleCount + CullScalarRange(frustum, input, visible, vectorCount);
+	}
+#endif
+
+	SpriteTransformKernel SpriteKernels::GetTransformKernel(SIMDLevel level)
+	{
+	#ifdef EC_SPRITE_KERNELS_X86
+		switch (level)
+		{
+			case SIMDLevel::AVX2: return TransformAVX2;
+			case SIMDLevel::SSE2: return TransformSSE2;
+			default: break;
+		}
+	#endif
+		return TransformScalar;
+	}
+
+	SpriteCullKernel SpriteKernels::GetCullKernel(SIMDLevel level)
+	{
+	#ifdef EC_SPRITE_KERNELS_X86
+		switch (level)
+		{
+			case SIMDLevel::AVX2: return CullAVX2;
+			case SIMDLevel::SSE2: return CullSSE2;
+			default: break;
+		}
+	#endif
+		return CullScalar;
+	}
+
+	double SpriteKernels::Benchmark(SIMDLevel level, uint32_t spriteCount, uint32_t iterations)
+	{
+		EC_PROFILE_FUNCTION();
+		EC_CORE_ASSERT(level <= CPUInfo::GetSIMDLevel(), "SIMD level not supported by this CPU!");
+
+		std::mt19937 engine(1234);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> size(0.1f, 4.0f);
+		std::uniform_real_distribution<float> rotation(-6.2831853f, 6.2831853f);
+
+		std::vector<float> inputs(spriteCount * 5);
+		for (uint32_t i = 0; i < spriteCount; i++)
+		{
+			inputs[i] = position(engine);
+			inputs[spriteCount + i] = position(engine);
+			inputs[spriteCount * 2 + i] = size(engine);
+			inputs[spriteCount * 3 + i] = size(engine);
+			inputs[spriteCount * 4 + i] = rotation(engine);
+		}
+
+		SpriteTransformInput input
+		{
+			.PositionX = inputs.data(),
+			.PositionY = inputs.data() + spriteCount,
+			.SizeX = inputs.data() + spriteCount * 2,
+			.SizeY = inputs.data() + spriteCount * 3,
+			.Rotation = inputs.data() + spriteCount * 4,
+			.Count = spriteCount
+		};
+
+		// Axes and corners, like the non instanced path
+		std::vector<float> outputs(spriteCount * 12);
+		SpriteTransformOutput output;
+		output.AxisXx = outputs.data();
+		output.AxisXy = outputs.data() + spriteCount;
+		output.AxisYx = outputs.data() + spriteCount * 2;
+		output.AxisYy = outputs.data() + spriteCount * 3;
+		for (int k = 0; k < 4; k++)
+		{
+			output.CornerX[k] = outputs.data() + spriteCount * (4 + k);
+			output.CornerY[k] = outputs.data() + spriteCount * (8 + k);
+		}
+
+		SpriteTransformKernel kernel = GetTransformKernel(level);
+		kernel(input, output);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			kernel(input, output);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+		return milliseconds > 0.0 ? (double)spriteCount * iterations / milliseconds : 0.0;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Core/CPUInfo.h"
+#include "Math/Frustum.h"
+
+#include <cstdint>
+
+namespace Echo
+{
+
+	// A run of sprites as plain float arrays, Count entries each. Rotation is in radians
+	struct SpriteTransformInput
+	{
+		const float* PositionX = nullptr;
+		const float* PositionY = nullptr;
+		const float* SizeX = nullptr;
+		const float* SizeY = nullptr;
+		const float* Rotation = nullptr;
+		uint32_t Count = 0;
+	};
+
+	// The 2D affine transform of every sprite: scaled local x axis (AxisXx, AxisXy) and y axis (AxisYx, AxisYy).
+	// CornerX/CornerY receive the four corners in Renderer2D's vertex order and may be null when only the axes are needed
+	struct SpriteTransformOutput
+	{
+		float* AxisXx = nullptr;
+		float* AxisXy = nullptr;
+		float* AxisYx = nullptr;
+		float* AxisYy = nullptr;
+
+		float* CornerX[4] = {};
+		float* CornerY[4] = {};
+	};
+
+	using SpriteTransformKernel = void(*)(const SpriteTransformInput& input, const SpriteTransformOutput& output);
+
+	// World space bounds of a run of sprites as center and half extents
+	struct SpriteBoundsInput
+	{
+		const float* CenterX = nullptr;
+		const float* CenterY = nullptr;
+		const float* CenterZ = nullptr;
+		const float* ExtentX = nullptr;
+		const float* ExtentY = nullptr;
+		// Null for sprites lying in the xy plane, whose boxes have no depth
+		const float* ExtentZ = nullptr;
+		uint32_t Count = 0;
+	};
+
+	// Sets visible[i] to 1 for every box that intersects the frustum and 0 for the rest, returns how many are visible
+	using SpriteCullKernel = uint32_t(*)(const Frustum& frustum, const SpriteBoundsInput& input, uint8_t* visible);
+
+	class SpriteKernels
+	{
+	public:
+		// Falls back to the best level below the requested one the build supports.
+		// The vector kernels evaluate sin/cos with a polynomial, accurate to about 1e-7 for |rotation| < 8192
+		static SpriteTransformKernel GetTransformKernel(SIMDLevel level);
+		// Same result as Frustum::IntersectsAABB per box
+		static SpriteCullKernel GetCullKernel(SIMDLevel level);
+
+		// Times the kernel of one level over spriteCount random sprites, in sprites per millisecond
+		static double Benchmark(SIMDLevel level, uint32_t spriteCount = 100000, uint32_t iterations = 20);
+	};
+
+}
\ No newline at end of file
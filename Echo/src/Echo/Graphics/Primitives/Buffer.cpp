@@ -30,6 +30,30 @@ namespace Echo
 		return nullptr;
 	}
 
+	Ref<StreamingVertexBuffer> StreamingVertexBuffer::Create(uint32_t blockSize)
+	{
+		Device* device = Application::Get().GetWindow().GetDevice();
+
+		switch (device->GetDeviceType())
+		{
+			case DeviceType::Vulkan:  return CreateScope<VulkanStreamingVertexBuffer>(device, blockSize);
+		}
+		EC_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<RetainedVertexBuffer> RetainedVertexBuffer::Create(uint32_t size)
+	{
+		Device* device = Application::Get().GetWindow().GetDevice();
+
+		switch (device->GetDeviceType())
+		{
+			case DeviceType::Vulkan:  return CreateScope<VulkanRetainedVertexBuffer>(device, size);
+		}
+		EC_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 	Ref<IndexBuffer> IndexBuffer::Create(std::vector<uint32_t> indices)
 	{
 		Device* device = Application::Get().GetWindow().GetDevice();
@@ -21,6 +21,52 @@ namespace Echo
 		static Ref<VertexBuffer> Create(uint32_t size, bool isDynamic = false);
 	};
 
+	// A region handed out by StreamingVertexBuffer::Allocate, only valid during the frame it was made in
+	struct StreamingAllocation
+	{
+		void* Data = nullptr;
+		uint32_t Size = 0;
+
+		uint32_t Block = 0;
+		uint64_t Offset = 0;
+	};
+
+	// Per-frame linear allocator over persistently mapped, host visible vertex memory. Every allocation
+	// gets its own region, so several batches can be recorded in one frame without overwriting each other.
+	// Grows by whole blocks when a frame needs more, memory is reused once the frame is back in flight
+	class StreamingVertexBuffer
+	{
+	public:
+		virtual ~StreamingVertexBuffer() = default;
+
+		virtual StreamingAllocation Allocate(uint32_t size) = 0;
+		// Gives the unused tail of the most recent allocation back
+		virtual void Trim(StreamingAllocation& allocation, uint32_t usedSize) = 0;
+
+		virtual void Bind(CommandBuffer* cmd, const StreamingAllocation& allocation) = 0;
+
+		static Ref<StreamingVertexBuffer> Create(uint32_t blockSize);
+	};
+
+	// Vertex data that stays in GPU visible memory across frames. Writes go to a CPU copy and only the
+	// written ranges are patched into each frame in flight's buffer, the next time that frame binds it
+	class RetainedVertexBuffer
+	{
+	public:
+		virtual ~RetainedVertexBuffer() = default;
+
+		// Only grows, existing contents are kept
+		virtual void Resize(uint32_t size) = 0;
+		virtual uint32_t GetSize() const = 0;
+
+		virtual void Write(uint32_t offset, const void* data, uint32_t size) = 0;
+
+		// Uploads the ranges this frame hasn't seen yet, then binds its buffer
+		virtual void Bind(CommandBuffer* cmd) = 0;
+
+		static Ref<RetainedVertexBuffer> Create(uint32_t size);
+	};
+
 	class IndexBuffer
 	{
 	public:
@@ -5,6 +5,8 @@
 namespace Echo 
 {
 
+	class CommandStream;
+
 	class CommandBuffer
 	{
 	public:
@@ -15,6 +17,9 @@ namespace Echo
 
 		virtual void Submit(bool isLastPass) = 0;
 
+		// Records every command of the stream, in order. Parallel allows spreading the work across the job system
+		virtual void Execute(const CommandStream& commands, bool parallel) = 0;
+
 		virtual void SetSourceFramebuffer(Ref<Framebuffer> framebuffer) = 0;
 		virtual void SetShouldPresent(bool shouldPresent) = 0;
 		virtual void SetDrawToSwapchain(bool drawToSwapchain) = 0;
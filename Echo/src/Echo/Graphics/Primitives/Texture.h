@@ -27,6 +27,11 @@ namespace Echo
 		virtual ~Texture2D() = default;
 
 		virtual void* GetImGuiResourceID() = 0;
+		// Stable slot in the device's texture table for the texture's whole lifetime,
+		// InvalidBindlessIndex if it can't be sampled that way
+		virtual uint32_t GetBindlessIndex() = 0;
+
+		static constexpr uint32_t InvalidBindlessIndex = UINT32_MAX;
 
 		static Ref<Texture2D> Create(const std::filesystem::path& path, const Texture2DSpecification& spec);
 		static Ref<Texture2D> Create(uint32_t width, uint32_t height, void* data);
@@ -7,8 +7,9 @@
 namespace Echo 
 {
 
-	enum class VertexFormat { Float, Float2, Float3, Float4, Int, Int2, Int3, Int4 };
+	enum class VertexFormat { Float, Float2, Float3, Float4, Int, Int2, Int3, Int4, UByte4Norm, UShort2Norm, UShort, UByte, Half };
 	enum class Topology { TriangleList, TriangleStrip, LineList, LineStrip, PointList };
+	enum class VertexInputRate { Vertex, Instance };
 	enum class DescriptorType { UniformBuffer, StorageBuffer, SampledImage, StorageImage };
 	enum class ShaderStage { Vertex, Fragment, Compute, Geometry, All };
 	enum class Cull { None, Front, Back };
@@ -21,7 +22,13 @@ namespace Echo
 		Float, Float2, Float3, Float4,
 		Int, Int2, Int3, Int4,
 		Mat3, Mat4,
-		Bool
+		Bool,
+		// Packed vertex attribute formats, the shader still sees the type noted next to each
+		UByte4Norm,  // float4, RGBA8 unorm
+		UShort2Norm, // float2, two 16-bit unorm
+		UShort,      // uint, 16-bit
+		UByte,       // uint, 8-bit
+		Half         // float, 16-bit
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -39,10 +46,42 @@ namespace Echo
 			case ShaderDataType::Mat3:      return 4 * 3 * 3;
 			case ShaderDataType::Mat4:      return 4 * 4 * 4;
 			case ShaderDataType::Bool:      return 1;
+			case ShaderDataType::UByte4Norm:  return 4;
+			case ShaderDataType::UShort2Norm: return 2 * 2;
+			case ShaderDataType::UShort:      return 2;
+			case ShaderDataType::UByte:       return 1;
+			case ShaderDataType::Half:        return 2;
 			default: return 0;
 		}
 	}
 
+	// Size of a single component, elements are aligned to it like the matching C++ struct members
+	static uint32_t ShaderDataTypeAlignment(ShaderDataType type)
+	{
+		switch (type)
+		{
+			case ShaderDataType::Bool:
+			case ShaderDataType::UByte:
+				return 1;
+			case ShaderDataType::UShort2Norm:
+			case ShaderDataType::UShort:
+			case ShaderDataType::Half:
+				return 2;
+			default: return 4;
+		}
+	}
+
+	// Maps the name used by a shader's [VertexFormat("...")] attribute
+	static ShaderDataType ShaderDataTypeFromString(const std::string& name)
+	{
+		if (name == "UByte4Norm")  return ShaderDataType::UByte4Norm;
+		if (name == "UShort2Norm") return ShaderDataType::UShort2Norm;
+		if (name == "UShort")      return ShaderDataType::UShort;
+		if (name == "UByte")       return ShaderDataType::UByte;
+		if (name == "Half")        return ShaderDataType::Half;
+		return ShaderDataType::None;
+	}
+
 	struct BufferElement
 	{
 		std::string Name;
@@ -70,6 +109,11 @@ namespace Echo
 				case ShaderDataType::Mat3:   return 3 * 3;
 				case ShaderDataType::Mat4:   return 4 * 4;
 				case ShaderDataType::Bool:   return 1;
+				case ShaderDataType::UByte4Norm:  return 4;
+				case ShaderDataType::UShort2Norm: return 2;
+				case ShaderDataType::UShort:      return 1;
+				case ShaderDataType::UByte:       return 1;
+				case ShaderDataType::Half:        return 1;
 			}
 			EC_CORE_ASSERT(false, "Unknown ShaderDataType!");
 			return 0;
@@ -136,13 +180,17 @@ namespace Echo
 		void CalculateOffsetsAndStride()
 		{
 			uint32_t offset = 0;
-			m_Stride = 0;
+			uint32_t maxAlignment = 1;
 			for (auto& element : m_Elements)
 			{
+				uint32_t alignment = ShaderDataTypeAlignment(element.Type);
+				maxAlignment = std::max(maxAlignment, alignment);
+
+				offset = (offset + alignment - 1) & ~(alignment - 1);
 				element.Offset = offset;
 				offset += element.Size;
-				m_Stride += element.Size;
 			}
+			m_Stride = (offset + maxAlignment - 1) & ~(maxAlignment - 1);
 		}
 	private:
 		std::vector<BufferElement> m_Elements;
@@ -171,6 +219,8 @@ namespace Echo
 
 		CompareOp DepthCompareOp = CompareOp::Less;
 		Topology GraphicsTopology = Topology::TriangleList;
+		// Instance advances the vertex buffer once per instance instead of once per vertex
+		VertexInputRate InputRate = VertexInputRate::Vertex;
 
 		float LineWidth = 1.0f;
 
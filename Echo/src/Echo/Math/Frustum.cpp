@@ -0,0 +1,38 @@
+#include "pch.h"
+#include "Frustum.h"
+
+namespace Echo
+{
+
+	Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection)
+	{
+		// Gribb and Hartmann, glm is column major so row i is m[0][i], m[1][i], ...
+		auto row = [&viewProjection](int i)
+		{
+			return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		};
+
+		Frustum frustum;
+		frustum.Planes[Left] = row(3) + row(0);
+		frustum.Planes[Right] = row(3) - row(0);
+		frustum.Planes[Bottom] = row(3) + row(1);
+		frustum.Planes[Top] = row(3) - row(1);
+		frustum.Planes[Near] = row(3) + row(2);
+		frustum.Planes[Far] = row(3) - row(2);
+		return frustum;
+	}
+
+	bool Frustum::IntersectsAABB(const glm::vec3& center, const glm::vec3& extents) const
+	{
+		for (const glm::vec4& plane : Planes)
+		{
+			// Distance of the center plus the box's projected radius onto the normal
+			float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+			float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+			if (distance + radius < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+}
\ No newline at end of file
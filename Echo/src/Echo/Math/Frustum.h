@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Echo
+{
+
+	// The six clip planes of a view projection, normals point inwards. Expects OpenGL style clip depth
+	// (-1 to 1), which also keeps everything a zero to one projection would keep
+	struct Frustum
+	{
+		enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+		// xyz is the plane normal, w the distance, a point p is inside when dot(xyz, p) + w >= 0
+		glm::vec4 Planes[Plane::Count];
+
+		static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+		// Conservative, a box near a frustum corner may be kept even though it's outside
+		bool IntersectsAABB(const glm::vec3& center, const glm::vec3& extents) const;
+	};
+
+}
\ No newline at end of file
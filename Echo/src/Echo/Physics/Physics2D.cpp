@@ -71,16 +71,17 @@ namespace Echo
 		}
 	}
 
-	glm::vec2 Physics2D::GetPosition(UUID uuid)
+	bool Physics2D::TryGetTransform(UUID uuid, glm::vec2& outPosition, float& outRotation) const
 	{
-		b2Vec2 position = b2Body_GetPosition(m_EntitiesPhysics[uuid].Body);
-		return glm::vec2(position.x, position.y);
-	}
+		// Read-only lookup, the physics sync reads bodies from several threads
+		auto it = m_EntitiesPhysics.find(uuid);
+		if (it == m_EntitiesPhysics.end())
+			return false;
 
-	float Physics2D::GetRotation(UUID uuid)
-	{
-		b2Rot rotation = b2Body_GetRotation(m_EntitiesPhysics[uuid].Body);
-		return b2Rot_GetAngle(rotation);
+		b2Vec2 position = b2Body_GetPosition(it->second.Body);
+		outPosition = glm::vec2(position.x, position.y);
+		outRotation = b2Rot_GetAngle(b2Body_GetRotation(it->second.Body));
+		return true;
 	}
 
 	void Physics2D::EndPhysicsWorld()
@@ -29,8 +29,8 @@ namespace Echo
 		void AddShape(UUID uuid, b2BodyId bodyId, b2ShapeDef* shapeDef, b2Polygon* polygon);
 		void AddShape(UUID uuid, b2BodyId bodyId, b2ShapeDef* shapeDef, b2Circle* polygon);
 
-		glm::vec2 GetPosition(UUID uuid);
-		float GetRotation(UUID uuid);
+		// False when the entity has no body in the world, e.g. its Rigidbody2D was added after the runtime started
+		bool TryGetTransform(UUID uuid, glm::vec2& outPosition, float& outRotation) const;
 
 		void EndPhysicsWorld();
 	private:
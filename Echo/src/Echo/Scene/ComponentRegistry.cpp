@@ -112,7 +112,8 @@ namespace Echo
 		return out;
 	}
 
-	std::unordered_map<std::type_index, ComponentMetadata> ComponentRegistry::s_ComponentRegistry;
+	std::vector<ComponentMetadata> ComponentRegistry::s_Components;
+	std::unordered_map<entt::id_type, ComponentID> ComponentRegistry::s_NameLookup;
 
 	// Helper function for drawing Vec3 controls (copied from EntityComponentPanel)
 	static void DrawVec3Control(const std::string& label, glm::vec3& values, float resetValues = 0.0f, float colWidth = 100)
@@ -222,10 +223,102 @@ namespace Echo
 		}
 	}
 
+	// Snapshot writers for components that can't be stored as raw memory
+	static void SnapshotComponent(SceneSnapshot::Writer& writer, const TagComponent& component)
+	{
+		writer.WriteString(component.Tag);
+	}
+
+	static void RestoreComponent(SceneSnapshot::Reader& reader, TagComponent& component)
+	{
+		component.Tag = reader.ReadString();
+	}
+
+	static void SnapshotComponent(SceneSnapshot::Writer& writer, const RelationshipComponent& component)
+	{
+		writer.Write(component.Parent);
+		writer.Write((uint32_t)component.Children.size());
+		writer.WriteBytes(component.Children.data(), component.Children.size() * sizeof(UUID));
+	}
+
+	static void RestoreComponent(SceneSnapshot::Reader& reader, RelationshipComponent& component)
+	{
+		component.Parent = reader.Read<uint64_t>();
+		// Filled with a fixed value, a default constructed UUID would generate a random one
+		component.Children.assign(reader.Read<uint32_t>(), UUID(0));
+		reader.ReadBytes(component.Children.data(), component.Children.size() * sizeof(UUID));
+	}
+
+	static void SnapshotComponent(SceneSnapshot::Writer& writer, const SpriteRendererComponent& component)
+	{
+		writer.Write(component.Color);
+		writer.WriteAsset(component.Texture);
+		writer.Write(component.TilingFactor);
+	}
+
+	static void RestoreComponent(SceneSnapshot::Reader& reader, SpriteRendererComponent& component)
+	{
+		component.Color = reader.Read<glm::vec4>();
+		component.Texture = reader.ReadAsset<TextureAsset>();
+		component.TilingFactor = reader.Read<float>();
+	}
+
+	static void SnapshotComponent(SceneSnapshot::Writer& writer, const CameraComponent& component)
+	{
+		const SceneCamera& camera = component.Camera;
+		writer.Write(camera.GetProjectionType());
+		writer.Write(camera.GetOrthographicSize());
+		writer.Write(camera.GetOrthographicNearClip());
+		writer.Write(camera.GetOrthographicFarClip());
+		writer.Write(camera.GetPerspectiveFOV());
+		writer.Write(camera.GetPerspectiveNearClip());
+		writer.Write(camera.GetPerspectiveFarClip());
+		writer.Write(camera.GetAspectRatio());
+		writer.Write(component.Primary);
+		writer.Write(component.FixedAspectRatio);
+	}
+
+	static void RestoreComponent(SceneSnapshot::Reader& reader, CameraComponent& component)
+	{
+		SceneCamera& camera = component.Camera;
+		camera.SetProjectionType(reader.Read<SceneCamera::ProjectionType>());
+		float orthographicSize = reader.Read<float>();
+		float orthographicNear = reader.Read<float>();
+		float orthographicFar = reader.Read<float>();
+		camera.SetOrthographic(orthographicSize, orthographicNear, orthographicFar);
+		float perspectiveFOV = reader.Read<float>();
+		float perspectiveNear = reader.Read<float>();
+		float perspectiveFar = reader.Read<float>();
+		camera.SetPerspective(perspectiveFOV, perspectiveNear, perspectiveFar);
+		camera.SetAspectRatio(reader.Read<float>());
+		component.Primary = reader.Read<bool>();
+		component.FixedAspectRatio = reader.Read<bool>();
+	}
+
+	static void SnapshotComponent(SceneSnapshot::Writer& writer, const MeshFilterComponent& component)
+	{
+		writer.WriteAsset(component.Mesh);
+	}
+
+	static void RestoreComponent(SceneSnapshot::Reader& reader, MeshFilterComponent& component)
+	{
+		component.Mesh = reader.ReadAsset<MeshAsset>();
+	}
+
 	template<typename T>
 	void ComponentRegistry::RegisterComponent(const std::string& name, const std::string& category, bool showInAddMenu, bool serializable, bool hasUI)
 	{
+		ComponentID& id = ComponentTypeID<T>::Value;
+		if (id == InvalidComponentID)
+		{
+			id = (ComponentID)s_Components.size();
+			s_Components.emplace_back();
+			// ComponentOrderComponent stores IDs in a byte
+			EC_CORE_ASSERT(id <= UINT8_MAX, "Too many registered component types!");
+		}
+
 		ComponentMetadata meta;
+		meta.ID = id;
 		meta.Name = name;
 		meta.Category = category;
 		meta.ShowInAddMenu = showInAddMenu;
@@ -262,6 +355,105 @@ namespace Echo
 			}
 		};
 
+		meta.CloneStorage = [](const entt::registry& source, entt::registry& destination)
+		{
+			const auto* srcStorage = source.storage<T>();
+			if (!srcStorage || srcStorage->empty())
+				return;
+
+			auto& dstStorage = destination.storage<T>();
+			const entt::sparse_set& srcEntities = *srcStorage;
+			if constexpr (std::is_empty_v<T>)
+			{
+				dstStorage.insert(srcEntities.begin(), srcEntities.end());
+			}
+			else if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				// Entity and component iterators walk the packed arrays in the same order
+				dstStorage.insert(srcEntities.begin(), srcEntities.end(), srcStorage->begin());
+			}
+			else
+			{
+				dstStorage.reserve(srcStorage->size());
+				for (auto [entity, component] : srcStorage->each())
+				{
+					dstStorage.emplace(entity, component);
+				}
+			}
+		};
+
+		meta.SnapshotStorage = [](const entt::registry& registry, SceneSnapshot::Writer& writer)
+		{
+			const auto* storage = registry.storage<T>();
+			uint32_t count = storage ? (uint32_t)storage->size() : 0;
+			writer.Write(entt::type_hash<T>::value());
+			writer.Write(count);
+			if (count == 0)
+				return;
+
+			const entt::sparse_set& entities = *storage;
+			writer.WriteBytes(entities.data(), count * sizeof(entt::entity));
+			if constexpr (std::is_empty_v<T>)
+			{
+				return;
+			}
+			else if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				// Pages hold the components in the same packed order as the entity array
+				constexpr uint32_t pageSize = (uint32_t)entt::component_traits<T>::page_size;
+				auto pages = storage->raw();
+				for (uint32_t first = 0; first < count; first += pageSize)
+				{
+					writer.WriteBytes(pages[first / pageSize], std::min(pageSize, count - first) * sizeof(T));
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					SnapshotComponent(writer, storage->get(entities.data()[i]));
+				}
+			}
+		};
+
+		meta.RestoreStorage = [](entt::registry& registry, SceneSnapshot::Reader& reader)
+		{
+			entt::id_type type = reader.Read<entt::id_type>();
+			EC_CORE_ASSERT(type == entt::type_hash<T>::value(), "Scene snapshot doesn't match the component registry!");
+			uint32_t count = reader.Read<uint32_t>();
+			if (count == 0)
+				return;
+
+			std::vector<entt::entity> entities(count);
+			reader.ReadBytes(entities.data(), count * sizeof(entt::entity));
+
+			auto& storage = registry.storage<T>();
+			EC_CORE_ASSERT(storage.empty(), "Scene snapshot must be restored into empty storages!");
+			if constexpr (std::is_empty_v<T>)
+			{
+				storage.insert(entities.begin(), entities.end());
+			}
+			else if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				// Insert placeholders, then overwrite the pages wholesale
+				storage.insert(entities.begin(), entities.end(), T{});
+				constexpr uint32_t pageSize = (uint32_t)entt::component_traits<T>::page_size;
+				auto pages = storage.raw();
+				for (uint32_t first = 0; first < count; first += pageSize)
+				{
+					reader.ReadBytes(pages[first / pageSize], std::min(pageSize, count - first) * sizeof(T));
+				}
+			}
+			else
+			{
+				storage.reserve(count);
+				for (entt::entity entity : entities)
+				{
+					RestoreComponent(reader, storage.emplace(entity));
+				}
+			}
+		};
+
 		meta.Serialize = [](const Entity& entity, YAML::Emitter& out)
 		{
 		};
@@ -278,18 +470,23 @@ namespace Echo
 		{
 		};
 
-		s_ComponentRegistry[GetTypeIndex<T>()] = meta;
+		s_Components[id] = meta;
+		s_NameLookup[entt::hashed_string::value(name.data(), name.size())] = id;
+
+		// An entity can hold every component with UI at once, ComponentOrderComponent must have room for all of them
+		EC_CORE_ASSERT(std::count_if(s_Components.begin(), s_Components.end(), [](const ComponentMetadata& m) { return m.HasUI; }) <= ComponentOrderComponent::MaxComponents,
+			"More components with UI than ComponentOrderComponent can track, raise MaxComponents!");
 	}
 
-	const std::unordered_map<std::type_index, ComponentMetadata>& ComponentRegistry::GetRegisteredComponents()
+	const std::vector<ComponentMetadata>& ComponentRegistry::GetRegisteredComponents()
 	{
-		return s_ComponentRegistry;
+		return s_Components;
 	}
 
 	std::vector<ComponentMetadata*> ComponentRegistry::GetComponentsByCategory(const std::string& category)
 	{
 		std::vector<ComponentMetadata*> components;
-		for (auto& [typeIndex, meta] : s_ComponentRegistry)
+		for (auto& meta : s_Components)
 		{
 			if (meta.Category == category)
 			{
@@ -302,30 +499,35 @@ namespace Echo
 	std::vector<std::string> ComponentRegistry::GetCategories()
 	{
 		std::set<std::string> uniqueCategories;
-		for (const auto& [typeIndex, meta] : s_ComponentRegistry)
+		for (const auto& meta : s_Components)
 		{
 			uniqueCategories.insert(meta.Category);
 		}
 		return std::vector<std::string>(uniqueCategories.begin(), uniqueCategories.end());
 	}
 
-	ComponentMetadata* ComponentRegistry::GetMetadataByName(const std::string& name)
+	ComponentID ComponentRegistry::GetComponentIDByName(std::string_view name)
 	{
-		for (auto& [typeIndex, meta] : s_ComponentRegistry)
+		auto it = s_NameLookup.find(entt::hashed_string::value(name.data(), name.size()));
+		if (it == s_NameLookup.end() || s_Components[it->second].Name != name)
+			return InvalidComponentID;
+
+		return it->second;
+	}
+
+	ComponentMetadata* ComponentRegistry::GetMetadataByName(std::string_view name)
+	{
+		ComponentMetadata* meta = GetMetadata(GetComponentIDByName(name));
+		if (!meta)
 		{
-			if (meta.Name == name)
-			{
-				return &meta;
-			}
+			EC_CORE_WARN("Component metadata not found for: {0}", name);
 		}
-
-		EC_CORE_WARN("Component metadata not found for: {0}", name);
-		return nullptr;
+		return meta;
 	}
 
 	void ComponentRegistry::SerializeEntity(const Entity& entity, YAML::Emitter& out)
 	{
-		for (const auto& [typeIndex, meta] : s_ComponentRegistry)
+		for (const auto& meta : s_Components)
 		{
 			if (meta.Serializable && meta.HasComponent(entity))
 			{
@@ -336,7 +538,7 @@ namespace Echo
 
 	void ComponentRegistry::DeserializeEntity(Entity& entity, const YAML::Node& entityNode)
 	{
-		for (const auto& [typeIndex, meta] : s_ComponentRegistry)
+		for (const auto& meta : s_Components)
 		{
 			if (meta.Serializable)
 			{
@@ -347,21 +549,23 @@ namespace Echo
 
 	void ComponentRegistry::DrawEntityUI(Entity& entity, const std::filesystem::path& currentDirectory)
 	{
-		// Get component order first
-		auto componentOrder = entity.GetComponentOrder();
+		// Copied, dropping a component reorders the entity's list while we walk it
+		const ComponentOrderComponent componentOrder = entity.GetComponentOrder();
 
 		// Draw components in specified order
-		for (const std::string& componentName : componentOrder)
+		for (uint32_t i = 0; i < componentOrder.Count; i++)
 		{
-			auto* meta = GetMetadataByName(componentName);
+			auto* meta = GetMetadata(componentOrder.Order[i]);
 			if (meta && meta->HasUI && meta->HasComponent(entity))
 			{
 				// Drag source
-				ImGui::InvisibleButton(("drag_" + componentName).c_str(), ImVec2(-1, 4));
+				ImGui::PushID((int)meta->ID);
+				ImGui::InvisibleButton("drag", ImVec2(-1, 4));
+				ImGui::PopID();
 				if (ImGui::BeginDragDropSource())
 				{
-					ImGui::SetDragDropPayload("COMPONENT_REORDER", componentName.c_str(), componentName.size() + 1);
-					ImGui::Text("Moving: %s", componentName.c_str());
+					ImGui::SetDragDropPayload("COMPONENT_REORDER", &meta->ID, sizeof(ComponentID));
+					ImGui::Text("Moving: %s", meta->Name.c_str());
 					ImGui::EndDragDropSource();
 				}
 
@@ -370,16 +574,8 @@ namespace Echo
 				{
 					if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("COMPONENT_REORDER"))
 					{
-						std::string draggedComponent((const char*)payload->Data);
-
-						// Find target index and reorder
-						auto order = entity.GetComponentOrder();
-						auto targetIt = std::find(order.begin(), order.end(), componentName);
-						if (targetIt != order.end())
-						{
-							size_t targetIndex = std::distance(order.begin(), targetIt);
-							entity.ReorderComponent(draggedComponent, targetIndex);
-						}
+						ComponentID draggedComponent = *(const ComponentID*)payload->Data;
+						entity.ReorderComponent(draggedComponent, i);
 					}
 					ImGui::EndDragDropTarget();
 				}
@@ -432,23 +628,37 @@ namespace Echo
 
 	void ComponentRegistry::CopyAllComponents(const Entity& source, Entity& destination)
 	{
-		for (const auto& [typeIndex, meta] : s_ComponentRegistry)
+		for (const auto& meta : s_Components)
 		{
 			meta.CopyComponent(source, destination);
 		}
 	}
 
-	template<typename T>
-	bool ComponentRegistry::IsRegistered()
+	void ComponentRegistry::CloneAllStorages(const entt::registry& source, entt::registry& destination)
 	{
-		return s_ComponentRegistry.find(GetTypeIndex<T>()) != s_ComponentRegistry.end();
+		EC_PROFILE_FUNCTION();
+		for (const auto& meta : s_Components)
+		{
+			meta.CloneStorage(source, destination);
+		}
 	}
 
-	template<typename T>
-	ComponentMetadata* ComponentRegistry::GetMetadata()
+	void ComponentRegistry::SnapshotAllStorages(const entt::registry& registry, SceneSnapshot::Writer& writer)
+	{
+		EC_PROFILE_FUNCTION();
+		for (const auto& meta : s_Components)
+		{
+			meta.SnapshotStorage(registry, writer);
+		}
+	}
+
+	void ComponentRegistry::RestoreAllStorages(entt::registry& registry, SceneSnapshot::Reader& reader)
 	{
-		auto it = s_ComponentRegistry.find(GetTypeIndex<T>());
-		return (it != s_ComponentRegistry.end()) ? &it->second : nullptr;
+		EC_PROFILE_FUNCTION();
+		for (const auto& meta : s_Components)
+		{
+			meta.RestoreStorage(registry, reader);
+		}
 	}
 
 	// Component-specific serialization and UI implementations
@@ -458,7 +668,9 @@ namespace Echo
 		RegisterComponent<IDComponent>("ID", "Core", false, false, false);
 		RegisterComponent<TagComponent>("Tag", "Core", false, true, false);
 		RegisterComponent<ComponentOrderComponent>("Component Order", "Core", false, true, false);
+		RegisterComponent<RelationshipComponent>("Relationship", "Core", false, true, false);
 		RegisterComponent<TransformComponent>("Transform", "Core", false, true, true);
+		RegisterComponent<WorldTransformComponent>("World Transform", "Core", false, false, false);
 
 		// Register rendering 2D components
 		RegisterComponent<SpriteRendererComponent>("Sprite Renderer", "Rendering 2D");
@@ -521,10 +733,14 @@ namespace Echo
 					out << YAML::BeginMap;
 					auto& orderComp = entity.GetComponent<ComponentOrderComponent>();
 
+					// Stored by name, IDs depend on registration order
 					out << YAML::Key << "ComponentOrder" << YAML::Value << YAML::BeginSeq;
-					for (const std::string& componentName : orderComp.ComponentOrder)
+					for (uint32_t i = 0; i < orderComp.Count; i++)
 					{
-						out << componentName;
+						if (const ComponentMetadata* componentMeta = ComponentRegistry::GetMetadata(orderComp.Order[i]))
+						{
+							out << componentMeta->Name;
+						}
 					}
 					out << YAML::EndSeq;
 					out << YAML::EndMap;
@@ -536,14 +752,63 @@ namespace Echo
 				auto componentOrderComponent = entityNode["ComponentOrderComponent"];
 				if (componentOrderComponent)
 				{
-					auto& orderComp = entity.AddComponent<ComponentOrderComponent>();
+					ComponentOrderComponent orderComp;
 
 					auto componentOrder = componentOrderComponent["ComponentOrder"];
 					if (componentOrder)
 					{
 						for (auto componentName : componentOrder)
 						{
-							orderComp.ComponentOrder.push_back(componentName.as<std::string>());
+							// Older scenes list every component, only the ones shown in the inspector are kept
+							const ComponentMetadata* componentMeta = ComponentRegistry::GetMetadata(ComponentRegistry::GetComponentIDByName(componentName.as<std::string>()));
+							if (componentMeta && componentMeta->HasUI)
+							{
+								orderComp.Add(componentMeta->ID);
+							}
+						}
+					}
+
+					entity.AddComponent<ComponentOrderComponent>(orderComp);
+				}
+			};
+		}
+
+		// RelationshipComponent
+		if (auto meta = ComponentRegistry::GetMetadata<RelationshipComponent>())
+		{
+			meta->Serialize = [](const Entity& entity, YAML::Emitter& out)
+			{
+				if (entity.HasComponent<RelationshipComponent>())
+				{
+					out << YAML::Key << "RelationshipComponent";
+					out << YAML::BeginMap;
+					auto& rc = entity.GetComponent<RelationshipComponent>();
+					out << YAML::Key << "Parent" << YAML::Value << (uint64_t)rc.Parent;
+
+					out << YAML::Key << "Children" << YAML::Value << YAML::BeginSeq;
+					for (const UUID& child : rc.Children)
+					{
+						out << (uint64_t)child;
+					}
+					out << YAML::EndSeq;
+					out << YAML::EndMap;
+				}
+			};
+
+			meta->Deserialize = [](Entity& entity, const YAML::Node& entityNode)
+			{
+				auto relationshipComponent = entityNode["RelationshipComponent"];
+				if (relationshipComponent)
+				{
+					auto& rc = entity.AddComponent<RelationshipComponent>();
+					rc.Parent = relationshipComponent["Parent"].as<uint64_t>();
+
+					auto children = relationshipComponent["Children"];
+					if (children)
+					{
+						for (auto child : children)
+						{
+							rc.Children.push_back(child.as<uint64_t>());
 						}
 					}
 				}
@@ -576,6 +841,7 @@ namespace Echo
 					tc.Translation = transformComponent["Translation"].as<glm::vec3>();
 					tc.Rotation = transformComponent["Rotation"].as<glm::vec3>();
 					tc.Scale = transformComponent["Scale"].as<glm::vec3>();
+					entity.PatchComponent<TransformComponent>();
 				}
 			};
 		}
@@ -818,13 +1084,18 @@ namespace Echo
 		{
 			meta->DrawUI = [](Entity& entity, const std::filesystem::path& currentDirectory)
 			{
-				DrawComponent<TransformComponent>("Transform", entity, [](auto& component)
+				DrawComponent<TransformComponent>("Transform", entity, [&entity](auto& component)
 				{
+					TransformComponent previous = component;
+
 					DrawVec3Control("Translation", component.Translation);
 					glm::vec3 rotation = glm::degrees(component.Rotation);
 					DrawVec3Control("Rotation", rotation);
 					component.Rotation = glm::radians(rotation);
 					DrawVec3Control("Scale", component.Scale, 1.0f);
+
+					if (component.Translation != previous.Translation || component.Rotation != previous.Rotation || component.Scale != previous.Scale)
+						entity.PatchComponent<TransformComponent>();
 				});
 			};
 		}
@@ -834,8 +1105,10 @@ namespace Echo
 		{
 			meta->DrawUI = [](Entity& entity, const std::filesystem::path& currentDirectory)
 			{
-				DrawComponent<SpriteRendererComponent>("Sprite Renderer", entity, [&currentDirectory](auto& component)
+				DrawComponent<SpriteRendererComponent>("Sprite Renderer", entity, [&currentDirectory, &entity](auto& component)
 				{
+					SpriteRendererComponent previous = component;
+
 					ImGui::ColorEdit4("Color", glm::value_ptr(component.Color));
 					ImGui::Button("Texture", ImVec2(100.0f, 0));
 
@@ -851,6 +1124,10 @@ namespace Echo
 					}
 
 					ImGui::DragFloat("Tiling Factor", &component.TilingFactor, 0.1f, 0.0f, 100.0f);
+
+					// Sprites are retained between frames, tell the scene this one needs uploading again
+					if (component.Color != previous.Color || component.Texture != previous.Texture || component.TilingFactor != previous.TilingFactor)
+						entity.PatchComponent<SpriteRendererComponent>();
 				});
 			};
 		}
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "Components.h"
+#include "SceneSnapshot.h"
 
 #include <yaml-cpp/yaml.h>
-#include <functional>
+#include <entt.hpp>
 #include <unordered_map>
-#include <typeindex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Echo
@@ -14,30 +15,43 @@ namespace Echo
 	// Forward declarations
 	class Entity;
 
+	// Dense index of a registered component type, assigned in registration order
+	using ComponentID = uint32_t;
+	constexpr ComponentID InvalidComponentID = UINT32_MAX;
+
 	// Component operation function types
-	using AddComponentFunc = std::function<void(Entity&)>;
-	using HasComponentFunc = std::function<bool(const Entity&)>;
-	using RemoveComponentFunc = std::function<void(Entity&)>;
-	using SerializeFunc = std::function<void(const Entity&, YAML::Emitter&)>;
-	using DeserializeFunc = std::function<void(Entity&, const YAML::Node&)>;
-	using DrawUIFunc = std::function<void(Entity&, const std::filesystem::path&)>;
-	using CopyComponentFunc = std::function<void(const Entity&, Entity&)>;
-	using InitializeComponentFunc = std::function<void(Entity&, void*)>;
+	using AddComponentFunc = void(*)(Entity&);
+	using HasComponentFunc = bool(*)(const Entity&);
+	using RemoveComponentFunc = void(*)(Entity&);
+	using SerializeFunc = void(*)(const Entity&, YAML::Emitter&);
+	using DeserializeFunc = void(*)(Entity&, const YAML::Node&);
+	using DrawUIFunc = void(*)(Entity&, const std::filesystem::path&);
+	using CopyComponentFunc = void(*)(const Entity&, Entity&);
+	using InitializeComponentFunc = void(*)(Entity&, void*);
+	using CloneStorageFunc = void(*)(const entt::registry&, entt::registry&);
+	using SnapshotStorageFunc = void(*)(const entt::registry&, SceneSnapshot::Writer&);
+	using RestoreStorageFunc = void(*)(entt::registry&, SceneSnapshot::Reader&);
 
 	// Metadata container for each component type
 	struct ComponentMetadata
 	{
+		ComponentID ID = InvalidComponentID;
 		std::string Name;
 		std::string Category = "General"; // For UI grouping
 
-		AddComponentFunc AddComponent;
-		HasComponentFunc HasComponent;
-		RemoveComponentFunc RemoveComponent;
-		SerializeFunc Serialize;
-		DeserializeFunc Deserialize;
-		DrawUIFunc DrawUI;
-		CopyComponentFunc CopyComponent;
-		InitializeComponentFunc InitializeComponent;
+		AddComponentFunc AddComponent = nullptr;
+		HasComponentFunc HasComponent = nullptr;
+		RemoveComponentFunc RemoveComponent = nullptr;
+		SerializeFunc Serialize = nullptr;
+		DeserializeFunc Deserialize = nullptr;
+		DrawUIFunc DrawUI = nullptr;
+		CopyComponentFunc CopyComponent = nullptr;
+		InitializeComponentFunc InitializeComponent = nullptr;
+		// Copies the whole component pool, destination must contain the same entity identifiers
+		CloneStorageFunc CloneStorage = nullptr;
+		// Writes/reads the whole component pool to/from a scene snapshot
+		SnapshotStorageFunc SnapshotStorage = nullptr;
+		RestoreStorageFunc RestoreStorage = nullptr;
 
 		bool ShowInAddMenu = true;
 		bool Serializable = true;
@@ -55,8 +69,8 @@ namespace Echo
 									  bool serializable = true,
 									  bool hasUI = true);
 
-		  // Get all registered components
-		static const std::unordered_map<std::type_index, ComponentMetadata>& GetRegisteredComponents();
+		// Get all registered components, indexed by ComponentID
+		static const std::vector<ComponentMetadata>& GetRegisteredComponents();
 
 		// Get components by category for UI grouping
 		static std::vector<ComponentMetadata*> GetComponentsByCategory(const std::string& category);
@@ -64,7 +78,9 @@ namespace Echo
 		// Get all unique categories
 		static std::vector<std::string> GetCategories();
 
-		static ComponentMetadata* GetMetadataByName(const std::string& name);
+		static ComponentMetadata* GetMetadata(ComponentID id) { return id < s_Components.size() ? &s_Components[id] : nullptr; }
+		static ComponentMetadata* GetMetadataByName(std::string_view name);
+		static ComponentID GetComponentIDByName(std::string_view name);
 
 		// Component operations
 		static void SerializeEntity(const Entity& entity, YAML::Emitter& out);
@@ -72,23 +88,35 @@ namespace Echo
 		static void DrawEntityUI(Entity& entity, const std::filesystem::path& currentDirectory);
 		static void DrawAddComponentMenu(Entity& entity);
 		static void CopyAllComponents(const Entity& source, Entity& destination);
+		static void CloneAllStorages(const entt::registry& source, entt::registry& destination);
+		static void SnapshotAllStorages(const entt::registry& registry, SceneSnapshot::Writer& writer);
+		// Registry must hold the snapshot's entity identifiers and no components
+		static void RestoreAllStorages(entt::registry& registry, SceneSnapshot::Reader& reader);
+
+		template<typename T>
+		static ComponentID GetComponentID() { return ComponentTypeID<T>::Value; }
 
 		// Check if a component type is registered
 		template<typename T>
-		static bool IsRegistered();
+		static bool IsRegistered() { return GetComponentID<T>() != InvalidComponentID; }
 
 		// Get metadata for a specific component type
 		template<typename T>
-		static ComponentMetadata* GetMetadata();
+		static ComponentMetadata* GetMetadata() { return GetMetadata(GetComponentID<T>()); }
 
 		// Initialize all component registrations
 		static void InitializeComponentRegistry();
 	private:
-		static std::unordered_map<std::type_index, ComponentMetadata> s_ComponentRegistry;
-
-		// Helper function to get type index
+		// Assigned the first time the type gets registered
 		template<typename T>
-		static std::type_index GetTypeIndex() { return std::type_index(typeid(T)); }
+		struct ComponentTypeID
+		{
+			static inline ComponentID Value = InvalidComponentID;
+		};
+
+		static std::vector<ComponentMetadata> s_Components;
+		// Hash of the display name to ID, names are compared on lookup to rule out collisions
+		static std::unordered_map<entt::id_type, ComponentID> s_NameLookup;
 
 		static void SetupComponentSerializers();
 		static void SetupComponentUI();
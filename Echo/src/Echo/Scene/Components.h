@@ -38,12 +38,78 @@ namespace Echo
 		{}
 	};
 
+	// Inspector display order of the entity's components, as ComponentRegistry IDs.
+	// Only components with UI are tracked, names are resolved by the inspector when drawing
 	struct ComponentOrderComponent
 	{
-		std::vector<std::string> ComponentOrder;
+		static constexpr uint32_t MaxComponents = 15;
+
+		uint8_t Count = 0;
+		uint8_t Order[MaxComponents] = {};
 
 		ComponentOrderComponent() = default;
 		ComponentOrderComponent(const ComponentOrderComponent&) = default;
+
+		bool Contains(uint32_t id) const { return IndexOf(id) != Count; }
+
+		uint32_t IndexOf(uint32_t id) const
+		{
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				if (Order[i] == id)
+					return i;
+			}
+			return Count;
+		}
+
+		void Add(uint32_t id) { Insert(id, Count); }
+
+		void Insert(uint32_t id, uint32_t index)
+		{
+			if (Contains(id))
+				return;
+
+			// Registration checks that every component with UI fits
+			EC_CORE_ASSERT(Count < MaxComponents, "Component order is full!");
+			if (Count == MaxComponents)
+				return;
+
+			index = std::min(index, (uint32_t)Count);
+			for (uint32_t i = Count; i > index; i--)
+			{
+				Order[i] = Order[i - 1];
+			}
+			Order[index] = (uint8_t)id;
+			Count++;
+		}
+
+		void Remove(uint32_t id)
+		{
+			uint32_t index = IndexOf(id);
+			if (index == Count)
+				return;
+
+			for (uint32_t i = index + 1; i < Count; i++)
+			{
+				Order[i - 1] = Order[i];
+			}
+			Count--;
+		}
+
+		void Move(uint32_t id, uint32_t newIndex)
+		{
+			Remove(id);
+			Insert(id, newIndex);
+		}
+	};
+
+	struct RelationshipComponent
+	{
+		UUID Parent = 0;
+		std::vector<UUID> Children;
+
+		RelationshipComponent() = default;
+		RelationshipComponent(const RelationshipComponent&) = default;
 	};
 
 	struct TransformComponent 
@@ -52,6 +118,9 @@ namespace Echo
 		glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
 		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
 
+		// Local to the parent entity, or world space for root entities.
+		// Patch the component after changing Translation/Rotation/Scale so the world matrix gets rebuilt
+
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
 		TransformComponent(const glm::vec3& translation)
@@ -69,6 +138,14 @@ namespace Echo
 		};
 	};
 
+	struct WorldTransformComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+
+		WorldTransformComponent() = default;
+		WorldTransformComponent(const WorldTransformComponent&) = default;
+	};
+
 	struct SpriteRendererComponent
 	{
 		glm::vec4 Color{1.0f, 1.0f, 1.0f, 1.0f};
@@ -11,90 +11,53 @@ namespace Echo
 	{}
 
 
-	void Entity::SetComponentOrder(const std::vector<std::string>& order)
+	ComponentOrderComponent& Entity::GetComponentOrder()
 	{
-		if (!HasComponent<ComponentOrderComponent>())
+		if (HasComponent<ComponentOrderComponent>())
 		{
-			AddComponent<ComponentOrderComponent>().ComponentOrder = order;
+			return GetComponent<ComponentOrderComponent>();
 		}
-		GetComponent<ComponentOrderComponent>().ComponentOrder = order;
-	}
 
-	std::vector<std::string> Entity::GetComponentOrder()
-	{
-		if (!HasComponent<ComponentOrderComponent>())
+		// Create default order if component doesn't exist
+		ComponentOrderComponent defaultOrder;
+
+		// Preferred logical order
+		const ComponentID preferredOrder[] = {
+			ComponentRegistry::GetComponentID<TransformComponent>(),
+			ComponentRegistry::GetComponentID<SpriteRendererComponent>(),
+			ComponentRegistry::GetComponentID<CircleRendererComponent>(),
+			ComponentRegistry::GetComponentID<CameraComponent>(),
+			ComponentRegistry::GetComponentID<MeshFilterComponent>(),
+			ComponentRegistry::GetComponentID<Rigidbody2DComponent>(),
+			ComponentRegistry::GetComponentID<BoxCollider2DComponent>(),
+			ComponentRegistry::GetComponentID<CircleCollider2DComponent>(),
+			ComponentRegistry::GetComponentID<NativeScriptComponent>()
+		};
+
+		// Add existing components in preferred order
+		for (ComponentID id : preferredOrder)
 		{
-            // Create default order if component doesn't exist
-			std::vector<std::string> defaultOrder;
-
-			// Preferred logical order
-			const std::vector<std::string> preferredOrder = {
-				"Transform", "Sprite Renderer", "Circle Renderer", "Camera",
-				"Mesh Filter", "Rigidbody 2D", "Box Collider 2D", "Circle Collider 2D",
-				"Native Script"
-			};
-
-			// Add existing components in preferred order
-			for (const std::string& componentName : preferredOrder)
-			{
-				auto* meta = ComponentRegistry::GetMetadataByName(componentName);
-				if (meta && meta->HasComponent(*this) && meta->HasUI)
-				{
-					defaultOrder.push_back(componentName);
-				}
-			}
-
-			// Add any remaining components not in preferred order
-			for (const auto& [typeIndex, meta] : ComponentRegistry::GetRegisteredComponents())
+			auto* meta = ComponentRegistry::GetMetadata(id);
+			if (meta && meta->HasUI && meta->HasComponent(*this))
 			{
-				if (meta.HasComponent(*this) && meta.HasUI)
-				{
-					if (std::find(defaultOrder.begin(), defaultOrder.end(), meta.Name) == defaultOrder.end())
-					{
-						defaultOrder.push_back(meta.Name);
-					}
-				}
+				defaultOrder.Add(id);
 			}
-
-			AddComponent<ComponentOrderComponent>().ComponentOrder = defaultOrder;
-			return defaultOrder;
-		}
-
-		return GetComponent<ComponentOrderComponent>().ComponentOrder;
-	}
-
-	void Entity::ReorderComponent(const std::string& componentName, size_t newIndex)
-	{
-		if (!HasComponent<ComponentOrderComponent>())
-		{
-			GetComponentOrder(); // Initialize with defaults
 		}
 
-		auto& order = GetComponent<ComponentOrderComponent>().ComponentOrder;
-
-		// Find the component in current order
-		auto it = std::find(order.begin(), order.end(), componentName);
-		if (it == order.end())
+		// Add any remaining components not in preferred order
+		for (const auto& meta : ComponentRegistry::GetRegisteredComponents())
 		{
-			// Component not in order list, add it at specified index
-			if (newIndex >= order.size())
+			if (meta.HasUI && meta.HasComponent(*this))
 			{
-				order.push_back(componentName);
+				defaultOrder.Add(meta.ID);
 			}
-			else
-			{
-				order.insert(order.begin() + newIndex, componentName);
-			}
-			return;
 		}
 
-		// Remove from current position
-		order.erase(it);
-
-		// Clamp newIndex to valid range
-		newIndex = std::min(newIndex, order.size());
+		return AddComponent<ComponentOrderComponent>(defaultOrder);
+	}
 
-		// Insert at new position
-		order.insert(order.begin() + newIndex, componentName);
+	void Entity::ReorderComponent(ComponentID id, size_t newIndex)
+	{
+		GetComponentOrder().Move(id, (uint32_t)newIndex);
 	}
 }
\ No newline at end of file
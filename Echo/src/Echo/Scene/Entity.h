@@ -25,14 +25,9 @@ namespace Echo
 				meta->InitializeComponent(*this, &component);
 			}
 
-			if (HasComponent<ComponentOrderComponent>()) 
+			if (meta && meta->HasUI)
 			{
-				GetComponent<ComponentOrderComponent>().ComponentOrder.push_back(meta->Name);
-			}
-			else 
-			{
-				GetComponentOrder();
-				GetComponent<ComponentOrderComponent>().ComponentOrder.push_back(meta->Name);
+				GetComponentOrder().Add(meta->ID);
 			}
 
 			return component;
@@ -41,11 +36,22 @@ namespace Echo
 		template<typename T>
 		T& GetComponent() const { return m_Scene->m_Registry.get<T>(m_EntityHandle); }
 
+		// Lets on_update listeners know a component was modified in place
+		template<typename T>
+		void PatchComponent() { m_Scene->m_Registry.patch<T>(m_EntityHandle); }
+
 		template<typename T>
 		bool HasComponent() const { return m_Scene->m_Registry.any_of<T>(m_EntityHandle); }
 
 		template<typename T>
-		void RemoveComponent() { m_Scene->m_Registry.remove<T>(m_EntityHandle); }
+		void RemoveComponent() 
+		{ 
+			m_Scene->m_Registry.remove<T>(m_EntityHandle); 
+			if (ComponentOrderComponent* order = m_Scene->m_Registry.try_get<ComponentOrderComponent>(m_EntityHandle))
+			{
+				order->Remove(ComponentRegistry::GetComponentID<T>());
+			}
+		}
 
 		operator bool() const { return m_EntityHandle != entt::null; }
 		operator uint32_t() const { return (uint32_t) m_EntityHandle; }
@@ -59,12 +65,16 @@ namespace Echo
 
 		glm::mat4 GetTransform() { return GetComponent<TransformComponent>().GetTransform(); }
 		const glm::mat4 GetTransform() const { return GetComponent<TransformComponent>().GetTransform(); }
+		const glm::mat4& GetWorldTransform() const { return GetComponent<WorldTransformComponent>().Transform; }
+
+		Entity GetParent() { return m_Scene->GetParent(*this); }
+		void SetParent(Entity parent) { m_Scene->SetParent(*this, parent); }
 
 		Scene* GetScene() { return m_Scene; }
 
-		void SetComponentOrder(const std::vector<std::string>& order);
-		std::vector<std::string> GetComponentOrder();
-		void ReorderComponent(const std::string& componentName, size_t newIndex);
+		// Created with the default order on first use
+		ComponentOrderComponent& GetComponentOrder();
+		void ReorderComponent(ComponentID id, size_t newIndex);
 
 		int GetDuplicatedNumber() { return m_DuplicateNumber; }
 		void AddDuplicatedNumber() { m_DuplicateNumber++; }
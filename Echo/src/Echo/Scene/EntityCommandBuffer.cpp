@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "EntityCommandBuffer.h"
+
+#include "Core/JobSystem.h"
+
+namespace Echo
+{
+
+	EntityCommandBuffer::EntityCommandBuffer(Scene* scene)
+		: m_Scene(scene)
+	{
+		m_ThreadBuffers.resize(JobSystem::GetThreadCount());
+	}
+
+	UUID EntityCommandBuffer::CreateEntity(const std::string& name)
+	{
+		UUID uuid;
+		Record(CommandType::CreateEntity, uuid, nullptr, name);
+		return uuid;
+	}
+
+	void EntityCommandBuffer::DestroyEntity(UUID entity)
+	{
+		Record(CommandType::DestroyEntity, entity, nullptr);
+	}
+
+	void EntityCommandBuffer::Record(CommandType type, UUID target, std::function<void(Entity&)> apply, const std::string& name)
+	{
+		const SystemRecordOrder& recordOrder = SystemRecordOrder::Current();
+		uint64_t order = ((uint64_t)recordOrder.System << 32) | recordOrder.Position;
+
+		uint32_t threadIndex = JobSystem::GetThreadIndex();
+		if (threadIndex < m_ThreadBuffers.size())
+		{
+			m_ThreadBuffers[threadIndex].push_back({ type, order, target, name, std::move(apply) });
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_ExternalMutex);
+		m_ExternalBuffer.push_back({ type, order, target, name, std::move(apply) });
+	}
+
+	void EntityCommandBuffer::Playback()
+	{
+		EC_PROFILE_FUNCTION();
+		size_t commandCount = m_ExternalBuffer.size();
+		for (const auto& buffer : m_ThreadBuffers)
+		{
+			commandCount += buffer.size();
+		}
+
+		if (commandCount == 0)
+			return;
+
+		std::vector<Command> commands;
+		commands.reserve(commandCount);
+		for (auto& buffer : m_ThreadBuffers)
+		{
+			std::move(buffer.begin(), buffer.end(), std::back_inserter(commands));
+			buffer.clear();
+		}
+		std::move(m_ExternalBuffer.begin(), m_ExternalBuffer.end(), std::back_inserter(commands));
+		m_ExternalBuffer.clear();
+
+		// A chunk runs on a single thread, so sorting by recording position and keeping each buffer's own
+		// order puts every command back where it was issued. A create always precedes the commands that
+		// use its UUID, a remove followed by an add leaves the component in place.
+		std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b)
+		{
+			return a.Order < b.Order;
+		});
+
+		for (Command& command : commands)
+		{
+			switch (command.Type)
+			{
+				case CommandType::CreateEntity:
+				{
+					m_Scene->CreateEntity(command.Name, command.Target);
+					m_Scene->AddEntityToOrder(command.Target);
+					break;
+				}
+				case CommandType::DestroyEntity:
+				{
+					// May already be gone together with a destroyed parent
+					Entity entity = m_Scene->TryGetEntityByUUID(command.Target);
+					if (entity)
+					{
+						m_Scene->DestroyEntity(entity);
+					}
+					break;
+				}
+				default:
+				{
+					Entity entity = m_Scene->TryGetEntityByUUID(command.Target);
+					if (entity)
+					{
+						command.Apply(entity);
+					}
+					break;
+				}
+			}
+		}
+	}
+
+}
\ No newline at end of file
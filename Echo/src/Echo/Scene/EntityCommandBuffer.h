@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Entity.h"
+#include "SystemScheduler.h"
+
+#include <functional>
+#include <mutex>
+
+namespace Echo
+{
+
+	// Records structural changes so they can be issued while iterating views or from job system workers,
+	// then applies them in one pass at a sync point. Each job system thread records into its own buffer, so
+	// recording never takes a lock. Playback follows the system and chunk that recorded each command (see
+	// SystemRecordOrder) and recording order within it, so the commands for an entity apply in the order
+	// they were issued and the result doesn't depend on thread scheduling.
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer(Scene* scene);
+		~EntityCommandBuffer() = default;
+
+		// The returned UUID can be used by later commands, the entity itself exists after Playback
+		UUID CreateEntity(const std::string& name = std::string());
+		void DestroyEntity(UUID entity);
+
+		template<typename T, typename... Args>
+		void AddComponent(UUID entity, Args&&... args)
+		{
+			Record(CommandType::AddComponent, entity, [component = T(std::forward<Args>(args)...)](Entity& target) mutable
+			{
+				target.AddComponent<T>(std::move(component));
+			});
+		}
+
+		template<typename T>
+		void SetComponent(UUID entity, const T& value)
+		{
+			Record(CommandType::SetComponent, entity, [value](Entity& target)
+			{
+				if (target.HasComponent<T>())
+				{
+					target.GetComponent<T>() = value;
+					target.PatchComponent<T>();
+				}
+				else
+					target.AddComponent<T>(value);
+			});
+		}
+
+		template<typename T>
+		void RemoveComponent(UUID entity)
+		{
+			Record(CommandType::RemoveComponent, entity, [](Entity& target)
+			{
+				if (target.HasComponent<T>())
+					target.RemoveComponent<T>();
+			});
+		}
+
+		// Must be called from the thread that owns the scene, with no recording in flight
+		void Playback();
+	private:
+		enum class CommandType : uint8_t
+		{
+			CreateEntity = 0,
+			AddComponent,
+			SetComponent,
+			RemoveComponent,
+			DestroyEntity
+		};
+
+		struct Command
+		{
+			CommandType Type;
+			// SystemRecordOrder at recording time, system in the high bits
+			uint64_t Order;
+			UUID Target;
+			std::string Name;
+			std::function<void(Entity&)> Apply;
+		};
+
+		void Record(CommandType type, UUID target, std::function<void(Entity&)> apply, const std::string& name = std::string());
+	private:
+		Scene* m_Scene;
+
+		std::vector<std::vector<Command>> m_ThreadBuffers;
+
+		// Used by threads the job system doesn't own
+		std::vector<Command> m_ExternalBuffer;
+		std::mutex m_ExternalMutex;
+	};
+
+}
\ No newline at end of file
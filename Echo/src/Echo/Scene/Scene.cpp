@@ -7,10 +7,15 @@
 
 #include "Entity.h"
 #include "ScriptableEntity.h"
+#include "EntityCommandBuffer.h"
 
 #include "Physics/Physics2D.h"
 #include "ComponentRegistry.h"
 
+#include "Math/Math.h"
+
+#include <chrono>
+
 namespace Echo
 {
 
@@ -25,8 +30,11 @@ namespace Echo
 		return b2_staticBody; // Default case
 	}
 
+	// Identifies the primary camera chosen for the frame in system access declarations
+	struct RuntimeCameraState {};
+
 	Scene::Scene()
-		: m_Physics2D(CreateScope<Physics2D>())
+		: m_Physics2D(CreateScope<Physics2D>()), m_CommandBuffer(CreateScope<EntityCommandBuffer>(this))
 	{
 		static bool registryInitialized = false;
 		if (!registryInitialized)
@@ -34,6 +42,9 @@ namespace Echo
 			ComponentRegistry::InitializeComponentRegistry();
 			registryInitialized = true;
 		}
+
+		RegisterRuntimeSystems();
+		ConnectRegistrySignals();
 	}
 
 	Scene::~Scene()
@@ -41,54 +52,147 @@ namespace Echo
 
 	}
 
-	template<typename T>
-	static void CopyComponent(entt::registry& srcRegistry, entt::registry& dstRegistry, std::unordered_map<UUID, entt::entity>& enttMap)
-	{
-		auto view = srcRegistry.view<IDComponent>();
-		for (auto& e : view)
-		{
-			if (srcRegistry.any_of<T>(e))
-			{
-				auto& component = srcRegistry.get<T>(e);
-				entt::entity dstEntity = enttMap.at(srcRegistry.get<IDComponent>(e).ID);
-
-				dstRegistry.emplace_or_replace<T>(dstEntity, component);
-			}
-		}
-	}
-
 	Ref<Scene> Scene::Copy(Ref<Scene> srcScene)
 	{
+		EC_PROFILE_FUNCTION();
 		Ref<Scene> newScene = CreateRef<Scene>();
 
 		// Copy scene properties
 		newScene->m_ViewportWidth = srcScene->m_ViewportWidth;
 		newScene->m_ViewportHeight = srcScene->m_ViewportHeight;
 
-		// Create entity mapping
-		std::unordered_map<UUID, Entity> enttMap;
-		auto view = srcScene->m_Registry.view<IDComponent>();
-		for (auto srcHandle : view)
+		newScene->m_EntityDisplayOrder = srcScene->m_EntityDisplayOrder;
+		// Entity identifiers are recreated as-is, so the UUID index can be copied directly
+		newScene->m_EntityMap = srcScene->m_EntityMap;
+
+		auto& srcEntities = srcScene->m_Registry.storage<entt::entity>();
+		auto& dstEntities = newScene->m_Registry.storage<entt::entity>();
+		dstEntities.reserve(srcEntities.size());
+		for (auto [entity] : srcEntities.each())
 		{
-			UUID uuid = srcScene->m_Registry.get<IDComponent>(srcHandle).ID;
-			std::string name = srcScene->m_Registry.get<TagComponent>(srcHandle).Tag;
+			entt::entity created = newScene->m_Registry.create(entity);
+			EC_CORE_ASSERT(created == entity, "Scene copy failed to preserve entity identifiers!");
+		}
 
-			// Create in destination registry
-			Entity dstEntity = newScene->CreateEntity(name, uuid);
-			enttMap[uuid] = dstEntity;
+		ComponentRegistry::CloneAllStorages(srcScene->m_Registry, newScene->m_Registry);
+
+		return newScene;
+	}
+
+	Ref<Scene> Scene::CreateBenchmarkScene(uint32_t entityCount)
+	{
+		EC_PROFILE_FUNCTION();
+		Ref<Scene> scene = CreateRef<Scene>();
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			Entity entity = scene->CreateEntity("Benchmark Entity " + std::to_string(i));
+			entity.GetComponent<TransformComponent>().Translation = { (float)(i % 256), (float)(i / 256), 0.0f };
+			entity.AddComponent<SpriteRendererComponent>().Color = { (i & 1) ? 1.0f : 0.5f, 0.5f, 1.0f, 1.0f };
 		}
+		return scene;
+	}
+
+	double Scene::BenchmarkCopy(uint32_t entityCount, bool bulk)
+	{
+		EC_PROFILE_FUNCTION();
+		Ref<Scene> scene = CreateBenchmarkScene(entityCount);
 
-		// Copy all components
-		for (auto& [uuid, dstEntity] : enttMap)
+		auto start = std::chrono::high_resolution_clock::now();
+		Ref<Scene> copy;
+		if (bulk)
 		{
-			Entity srcEntity = srcScene->GetEntityByUUID(uuid);
-			if (srcEntity.GetHandle() != entt::null)
+			copy = Copy(scene);
+		}
+		else
+		{
+			copy = CreateRef<Scene>();
+			copy->m_EntityMap = scene->m_EntityMap;
+			for (auto [entity] : scene->m_Registry.storage<entt::entity>().each())
 			{
-				ComponentRegistry::CopyAllComponents(srcEntity, dstEntity);
+				Entity destination = { copy->m_Registry.create(entity), copy.get() };
+				ComponentRegistry::CopyAllComponents(Entity{ entity, scene.get() }, destination);
 			}
 		}
+		auto end = std::chrono::high_resolution_clock::now();
 
-		return newScene;
+		EC_CORE_ASSERT(copy->m_EntityMap.size() == entityCount, "Scene copy lost entities!");
+		EC_CORE_ASSERT(copy->m_Registry.storage<SpriteRendererComponent>().size() == entityCount, "Scene copy lost components!");
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	Ref<SceneSnapshot> Scene::CreateSnapshot()
+	{
+		EC_PROFILE_FUNCTION();
+		Ref<SceneSnapshot> snapshot = CreateRef<SceneSnapshot>();
+		SceneSnapshot::Writer writer(*snapshot);
+
+		writer.Write(m_ViewportWidth);
+		writer.Write(m_ViewportHeight);
+
+		writer.Write((uint32_t)m_EntityDisplayOrder.size());
+		writer.WriteBytes(m_EntityDisplayOrder.data(), m_EntityDisplayOrder.size() * sizeof(UUID));
+
+		// Only the alive entities, in the order the registry hands them out
+		auto& entities = m_Registry.storage<entt::entity>();
+		uint32_t entityCount = (uint32_t)entities.free_list();
+		writer.Write(entityCount);
+		writer.WriteBytes(entities.data(), entityCount * sizeof(entt::entity));
+
+		ComponentRegistry::SnapshotAllStorages(m_Registry, writer);
+		return snapshot;
+	}
+
+	void Scene::RestoreSnapshot(const SceneSnapshot& snapshot)
+	{
+		EC_PROFILE_FUNCTION();
+		// Script instances aren't part of the snapshot, they get recreated on the next runtime update
+		for (auto [e, nsc] : m_Registry.view<NativeScriptComponent>().each())
+		{
+			if (nsc.Instance)
+			{
+				nsc.Instance->OnDestroy();
+				nsc.DestroyScript(&nsc);
+			}
+		}
+
+		m_Registry = entt::registry();
+		m_EntityMap.clear();
+		m_TransformHierarchy.Invalidate();
+		m_RuntimeCamera = nullptr;
+
+		ConnectRegistrySignals();
+		m_SpriteBatchValid = false;
+
+		SceneSnapshot::Reader reader(snapshot);
+		m_ViewportWidth = reader.Read<uint32_t>();
+		m_ViewportHeight = reader.Read<uint32_t>();
+
+		m_EntityDisplayOrder.assign(reader.Read<uint32_t>(), UUID(0));
+		reader.ReadBytes(m_EntityDisplayOrder.data(), m_EntityDisplayOrder.size() * sizeof(UUID));
+
+		std::vector<entt::entity> entities(reader.Read<uint32_t>());
+		reader.ReadBytes(entities.data(), entities.size() * sizeof(entt::entity));
+		m_Registry.storage<entt::entity>().reserve(entities.size());
+		for (entt::entity entity : entities)
+		{
+			entt::entity created = m_Registry.create(entity);
+			EC_CORE_ASSERT(created == entity, "Scene snapshot failed to preserve entity identifiers!");
+		}
+
+		ComponentRegistry::RestoreAllStorages(m_Registry, reader);
+		EC_CORE_ASSERT(reader.IsAtEnd(), "Scene snapshot wasn't fully restored!");
+
+		auto ids = m_Registry.view<IDComponent>();
+		m_EntityMap.reserve(ids.size());
+		for (auto [e, id] : ids.each())
+		{
+			m_EntityMap[id.ID] = e;
+		}
+
+		for (auto [e, nsc] : m_Registry.view<NativeScriptComponent>().each())
+		{
+			nsc.Instance = nullptr;
+		}
 	}
 
 	Entity Scene::CreateEntity(const std::string& name)
@@ -96,9 +200,12 @@ namespace Echo
 		Entity entity = { m_Registry.create(), this };
 		entity.AddComponent<IDComponent>();
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
 		auto& tag = entity.AddComponent<TagComponent>();
 		tag.Tag = name.empty() ? "Unnamed Entity" : name;
 
+		m_EntityMap[entity.GetUUID()] = entity.GetHandle();
+		m_TransformHierarchy.Invalidate();
 		m_EntityDisplayOrder.push_back(entity.GetUUID()); 
 		return entity;
 	}
@@ -108,23 +215,28 @@ namespace Echo
 		Entity entity = { m_Registry.create(), this };
 		entity.AddComponent<IDComponent>(UUID(uuid));
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
 		auto& tag = entity.AddComponent<TagComponent>();
 		tag.Tag = name.empty() ? "Unnamed Entity" : name;
 
+		m_EntityMap[UUID(uuid)] = entity.GetHandle();
+		m_TransformHierarchy.Invalidate();
 		return entity;
 	}
 
-
 	Entity Scene::GetEntityByUUID(UUID uuid)
 	{
-		auto view = m_Registry.view<IDComponent>();
-		for (auto entityHandle : view)
+		Entity entity = TryGetEntityByUUID(uuid);
+		EC_CORE_ASSERT(entity, "Entity not found in scene!");
+		return entity;
+	}
+
+	Entity Scene::TryGetEntityByUUID(UUID uuid)
+	{
+		auto it = m_EntityMap.find(uuid);
+		if (it != m_EntityMap.end())
 		{
-			Entity entity{ entityHandle, this };
-			if (entity.GetComponent<IDComponent>().ID == uuid)
-			{
-				return entity;
-			}
+			return Entity{ it->second, this };
 		}
 
 		// Return invalid entity if not found
@@ -151,22 +263,151 @@ namespace Echo
 		std::string name = entity.GetComponent<TagComponent>().Tag;
 		name += " (" + std::to_string(entity.GetDuplicatedNumber()) + ")";
 
+		Entity newEntity = CopyEntityTree(entity, name);
+		Entity parent = GetParent(entity);
+		if (parent)
+		{
+			LinkChild(parent, newEntity);
+		}
+
+		entity.AddDuplicatedNumber();
+	}
+
+	Entity Scene::CopyEntityTree(Entity entity, const std::string& name)
+	{
 		Entity newEntity = CreateEntity(name);
+		UUID newUUID = newEntity.GetUUID();
 		ComponentRegistry::CopyAllComponents(entity, newEntity);
 		newEntity.GetComponent<TagComponent>().Tag = name;
-		newEntity.GetComponent<IDComponent>().ID = UUID();
+		// CopyAllComponents overwrites the ID, restore the one registered by CreateEntity
+		newEntity.GetComponent<IDComponent>().ID = newUUID;
 
-		entity.AddDuplicatedNumber();
+		if (newEntity.HasComponent<RelationshipComponent>())
+		{
+			auto& relationship = newEntity.GetComponent<RelationshipComponent>();
+			relationship.Parent = 0;
+			relationship.Children.clear();
+
+			std::vector<UUID> children = entity.GetComponent<RelationshipComponent>().Children;
+			for (UUID childID : children)
+			{
+				Entity child = TryGetEntityByUUID(childID);
+				if (child)
+				{
+					LinkChild(newEntity, CopyEntityTree(child, child.GetComponent<TagComponent>().Tag));
+				}
+			}
+		}
+
+		return newEntity;
+	}
+
+	void Scene::SetParent(Entity child, Entity parent)
+	{
+		if (parent && (parent == child || IsDescendantOf(parent, child)))
+		{
+			EC_CORE_WARN("Cannot parent an entity to itself or to one of its children");
+			return;
+		}
+
+		glm::mat4 worldTransform = GetWorldTransform(child);
+
+		UnlinkChild(child);
+		if (parent)
+		{
+			LinkChild(parent, child);
+		}
+
+		// Keep the entity where it was in world space
+		glm::mat4 localTransform = parent ? glm::inverse(GetWorldTransform(parent)) * worldTransform : worldTransform;
+		auto& transform = child.GetComponent<TransformComponent>();
+		Math::DecomposeTransform(localTransform, transform.Translation, transform.Rotation, transform.Scale);
+		child.PatchComponent<TransformComponent>();
+	}
+
+	Entity Scene::GetParent(Entity entity)
+	{
+		if (!entity.HasComponent<RelationshipComponent>())
+			return Entity{ entt::null, this };
+
+		return TryGetEntityByUUID(entity.GetComponent<RelationshipComponent>().Parent);
+	}
+
+	bool Scene::IsDescendantOf(Entity entity, Entity ancestor)
+	{
+		Entity parent = GetParent(entity);
+		while (parent)
+		{
+			if (parent == ancestor)
+				return true;
+			parent = GetParent(parent);
+		}
+		return false;
+	}
+
+	glm::mat4 Scene::GetWorldTransform(Entity entity)
+	{
+		glm::mat4 transform = entity.GetComponent<TransformComponent>().GetTransform();
+		for (Entity parent = GetParent(entity); parent; parent = GetParent(parent))
+		{
+			transform = parent.GetComponent<TransformComponent>().GetTransform() * transform;
+		}
+		return transform;
+	}
+
+	void Scene::LinkChild(Entity parent, Entity child)
+	{
+		if (!parent.HasComponent<RelationshipComponent>())
+			parent.AddComponent<RelationshipComponent>();
+		if (!child.HasComponent<RelationshipComponent>())
+			child.AddComponent<RelationshipComponent>();
+
+		parent.GetComponent<RelationshipComponent>().Children.push_back(child.GetUUID());
+		child.GetComponent<RelationshipComponent>().Parent = parent.GetUUID();
+		m_TransformHierarchy.Invalidate();
+	}
+
+	void Scene::UnlinkChild(Entity child)
+	{
+		if (!child.HasComponent<RelationshipComponent>())
+			return;
+
+		auto& relationship = child.GetComponent<RelationshipComponent>();
+		Entity parent = TryGetEntityByUUID(relationship.Parent);
+		if (parent && parent.HasComponent<RelationshipComponent>())
+		{
+			auto& siblings = parent.GetComponent<RelationshipComponent>().Children;
+			siblings.erase(std::remove(siblings.begin(), siblings.end(), child.GetUUID()), siblings.end());
+		}
+		relationship.Parent = 0;
+		m_TransformHierarchy.Invalidate();
 	}
 
 	void Scene::DestroyEntity(Entity entity)
 	{
-		auto it = std::find(m_EntityDisplayOrder.begin(), m_EntityDisplayOrder.end(), entity.GetUUID());
+		if (entity.HasComponent<RelationshipComponent>())
+		{
+			std::vector<UUID> children = entity.GetComponent<RelationshipComponent>().Children;
+			for (UUID childID : children)
+			{
+				Entity child = TryGetEntityByUUID(childID);
+				if (child)
+				{
+					DestroyEntity(child);
+				}
+			}
+			UnlinkChild(entity);
+		}
+
+		UUID uuid = entity.GetUUID();
+		auto it = std::find(m_EntityDisplayOrder.begin(), m_EntityDisplayOrder.end(), uuid);
 		if (it != m_EntityDisplayOrder.end())
 		{
 			m_EntityDisplayOrder.erase(it);
 		}
+		m_EntityMap.erase(uuid);
 		m_Registry.destroy(entity);
+		m_TransformHierarchy.Invalidate();
 	}
 
 	void Scene::ReorderEntity(UUID entityUUID, size_t newIndex)
@@ -255,107 +496,258 @@ namespace Echo
 	void Scene::OnUpdateEditor(CommandList& cmd, const EditorCamera& camera, Timestep ts)
 	{
 		EC_PROFILE_FUNCTION();
-		Renderer2D::BeginScene(cmd, camera);
-
-		{
-			auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>();
-			for (auto entity : view)
-			{
-				auto [transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
-				Renderer2D::DrawQuad({ .InstanceID = (int)(uint32_t)entity, .Color = sprite.Color, .Texture = sprite.Texture ? sprite.Texture->GetTexture() : nullptr, .TilingFactor = sprite.TilingFactor}, transform.GetTransform());
-			}
-		}
-
-		{
-			auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-			for (auto entity : view)
-			{
-				auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
-				Renderer2D::DrawCircle({ .InstanceID = (int)(uint32_t)entity, .Color = circle.Color, .OutlineThickness = circle.OutlineThickness, .Fade = circle.Fade }, transform.GetTransform());
-			}
-		}
+		UpdateWorldTransforms();
 
+		Renderer2D::BeginScene(cmd, camera);
+		SubmitRenderables();
 		Renderer2D::EndScene();
 	}
 
 	void Scene::OnUpdateRuntime(CommandList& cmd, Timestep ts)
 	{
 		EC_PROFILE_FUNCTION();
-		m_Registry.view<NativeScriptComponent>().each([=](auto entity, auto& nsc)
-		{
-			if (!nsc.Instance)
-			{
-				nsc.Instance = nsc.InstantiateScript();
-				nsc.Instance->m_Entity = Entity{ entity, this };
+		SystemContext context;
+		context.ActiveScene = this;
+		context.Registry = &m_Registry;
+		context.Commands = &cmd;
+		context.EntityCommands = m_CommandBuffer.get();
+		context.TS = ts;
 
-				nsc.Instance->OnCreate();
-			}
+		m_RuntimeSystems.Run(context);
 
-			nsc.Instance->OnUpdate(ts);
-		});
+		m_CommandBuffer->Playback();
+	}
 
-		Camera* mainCamera = nullptr;
-		glm::mat4 cameraTransform;
+	void Scene::RegisterRuntimeSystems()
+	{
+		m_RuntimeSystems.AddSystem("Native Scripts", SystemAccess().Exclusive(), [this](SystemContext& context)
 		{
-			auto view = m_Registry.view<TransformComponent, CameraComponent>();
-			for (auto entity : view)
+			m_Registry.view<NativeScriptComponent>().each([&](auto entity, auto& nsc)
 			{
-				auto [transform, camera] = view.get<TransformComponent, CameraComponent>(entity);
-
-				if (camera.Primary)
+				if (!nsc.Instance)
 				{
-					mainCamera = &camera.Camera;
-					cameraTransform = transform.GetTransform();
-					break;
+					nsc.Instance = nsc.InstantiateScript();
+					nsc.Instance->m_Entity = Entity{ entity, this };
+
+					nsc.Instance->OnCreate();
 				}
-			}
-		}
 
-		// Physics
+				nsc.Instance->OnUpdate(context.TS);
+			});
+		});
+
+		m_RuntimeSystems.AddSystem("Physics Step", SystemAccess().Write<Physics2D>(), [this](SystemContext& context)
 		{
 			int subStepCount = 4;
 			m_Physics2D->Step(1.0f / 60.0f, subStepCount);
+		});
 
-			auto view = m_Registry.view<Rigidbody2DComponent>();
-			for (auto e : view)
+		m_RuntimeSystems.AddSystem("Physics Sync", SystemAccess().Read<Physics2D, Rigidbody2DComponent, IDComponent>().Write<TransformComponent>(), [this](SystemContext& context)
+		{
+			context.ParallelEach<Rigidbody2DComponent>([this](entt::entity entity)
 			{
-				Entity entity = { e, this };
+				UUID uuid = m_Registry.get<IDComponent>(entity).ID;
 
-				auto& transform = entity.GetComponent<TransformComponent>();
-				auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
+				// Bodies are only created when the runtime starts, later rigidbodies keep their transform
+				glm::vec2 position;
+				float rotation;
+				if (!m_Physics2D->TryGetTransform(uuid, position, rotation))
+					return;
 
-				const auto& position = m_Physics2D->GetPosition(entity.GetUUID());
+				auto& transform = m_Registry.get<TransformComponent>(entity);
 				transform.Translation.x = position.x;
 				transform.Translation.y = position.y;
-				const auto& rotation = m_Physics2D->GetRotation(entity.GetUUID());
 				transform.Rotation.z = rotation;
-			}
-		}
+				m_Registry.patch<TransformComponent>(entity);
+			});
+		});
+
+		m_RuntimeSystems.AddSystem("Transform Propagation", SystemAccess().Read<RelationshipComponent>().Write<TransformComponent, WorldTransformComponent>(), [this](SystemContext& context)
+		{
+			UpdateWorldTransforms();
+		});
 
-		if (mainCamera != nullptr)
+		m_RuntimeSystems.AddSystem("Camera Search", SystemAccess().Read<CameraComponent, WorldTransformComponent>().Write<RuntimeCameraState>(), [this](SystemContext& context)
 		{
-			Renderer2D::BeginScene(cmd, *mainCamera, cameraTransform);
+			m_RuntimeCamera = nullptr;
 
+			auto view = m_Registry.view<WorldTransformComponent, CameraComponent>();
+			for (auto entity : view)
 			{
-				auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>();
-				for (auto entity : view)
+				auto [transform, camera] = view.get<WorldTransformComponent, CameraComponent>(entity);
+
+				if (camera.Primary)
 				{
-					auto [transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
-					Renderer2D::DrawQuad({ .InstanceID = (int)(uint32_t)entity, .Color = sprite.Color, .Texture = sprite.Texture ? sprite.Texture->GetTexture() : nullptr, .TilingFactor = sprite.TilingFactor}, transform.GetTransform());
+					m_RuntimeCamera = &camera.Camera;
+					m_RuntimeCameraTransform = transform.Transform;
+					break;
 				}
 			}
+		});
+
+		m_RuntimeSystems.AddSystem("Render Submission", SystemAccess().MainThread().Read<RuntimeCameraState, WorldTransformComponent, SpriteRendererComponent, CircleRendererComponent>(), [this](SystemContext& context)
+		{
+			if (m_RuntimeCamera == nullptr)
+				return;
+
+			Renderer2D::BeginScene(*context.Commands, *m_RuntimeCamera, m_RuntimeCameraTransform);
+			SubmitRenderables();
+			Renderer2D::EndScene();
+		});
+	}
+
+	void Scene::SubmitRenderables()
+	{
+		EC_PROFILE_FUNCTION();
+		SyncSpriteBatch();
+		Renderer2D::DrawRetained(m_SpriteBatch);
+
+		{
+			// Recorded across the job system, one batch builder per chunk of the view
+			auto view = m_Registry.view<WorldTransformComponent, CircleRendererComponent>();
+			const auto* storage = view.handle();
+			if (storage)
+			{
+				const entt::entity* entities = storage->data();
+				Renderer2D::DrawParallel((uint32_t)storage->size(), 1024, [&view, entities](BatchBuilder2D& builder, uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						entt::entity entity = entities[i];
+						if (!view.contains(entity))
+							continue;
+
+						auto [transform, circle] = view.get<WorldTransformComponent, CircleRendererComponent>(entity);
+						builder.DrawCircle({ .InstanceID = (int)(uint32_t)entity, .Color = circle.Color, .OutlineThickness = circle.OutlineThickness, .Fade = circle.Fade }, transform.Transform);
+					}
+				});
+			}
+		}
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		m_TransformHierarchy.Update(m_Registry, m_EntityMap);
+
+		// Moved sprites are picked up by the next SyncSpriteBatch, which may be frames away without a camera
+		for (entt::entity entity : m_TransformHierarchy.GetUpdatedEntities())
+		{
+			if (m_Registry.all_of<SpriteRendererComponent>(entity))
+				m_DirtySprites.push_back(entity);
+		}
+	}
 
+	void Scene::ConnectRegistrySignals()
+	{
+		m_Registry.on_construct<SpriteRendererComponent>().connect<&Scene::OnSpriteChanged>(this);
+		m_Registry.on_update<SpriteRendererComponent>().connect<&Scene::OnSpriteChanged>(this);
+		m_Registry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnSpriteRemoved>(this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnTransformChanged>(this);
+	}
+
+	void Scene::OnTransformChanged(entt::registry& registry, entt::entity entity)
+	{
+		m_TransformHierarchy.MarkDirty(entity);
+	}
+
+	void Scene::OnSpriteChanged(entt::registry& registry, entt::entity entity)
+	{
+		m_DirtySprites.push_back(entity);
+	}
+
+	void Scene::OnSpriteRemoved(entt::registry& registry, entt::entity entity)
+	{
+		auto it = m_SpriteSlots.find(entity);
+		if (it == m_SpriteSlots.end())
+			return;
+
+		m_SpriteBatch->Remove(it->second);
+		m_SpriteSlots.erase(it);
+	}
+
+	void Scene::SyncSpriteBatch()
+	{
+		EC_PROFILE_FUNCTION();
+		if (!m_SpriteBatch)
+		{
+			m_SpriteBatch = CreateRef<RetainedQuadBatch>();
+		}
+
+		if (!m_SpriteBatchValid)
+		{
+			m_SpriteBatch->Clear();
+			m_SpriteSlots.clear();
+			m_DirtySprites.clear();
+
+			auto view = m_Registry.view<SpriteRendererComponent>();
+			m_DirtySprites.assign(view.begin(), view.end());
+			m_SpriteBatchValid = true;
+		}
+
+		// An entity can be listed more than once, UpdateParallel needs every slot once
+		std::sort(m_DirtySprites.begin(), m_DirtySprites.end());
+		m_DirtySprites.erase(std::unique(m_DirtySprites.begin(), m_DirtySprites.end()), m_DirtySprites.end());
+
+		// Slots are looked up and taken here, the map and the batch's free list aren't shared
+		auto view = m_Registry.view<SpriteRendererComponent, WorldTransformComponent>();
+		m_SyncEntities.clear();
+		m_SyncSlots.clear();
+		for (entt::entity entity : m_DirtySprites)
+		{
+			if (!m_Registry.valid(entity) || !view.contains(entity))
+				continue;
+
+			auto [it, inserted] = m_SpriteSlots.try_emplace(entity, 0);
+			if (inserted)
+				it->second = m_SpriteBatch->Add();
+
+			m_SyncEntities.push_back(entity);
+			m_SyncSlots.push_back(it->second);
+		}
+		m_DirtySprites.clear();
+
+		// Building the instances is the expensive part, the view is only read from the jobs
+		const entt::entity* entities = m_SyncEntities.data();
+		m_SpriteBatch->UpdateParallel(m_SyncSlots, 1024, [&view, entities](uint32_t index, VertexQuadData& data, glm::mat4& transform)
+		{
+			entt::entity entity = entities[index];
+			auto [world, sprite] = view.get<WorldTransformComponent, SpriteRendererComponent>(entity);
+
+			data = { .InstanceID = (int)(uint32_t)entity, .Color = sprite.Color, .Texture = sprite.Texture ? sprite.Texture->GetTexture() : nullptr, .TilingFactor = sprite.TilingFactor };
+			transform = world.Transform;
+		});
+	}
+
+	SceneMemoryReport Scene::GetMemoryReport() const
+	{
+		EC_PROFILE_FUNCTION();
+		SceneMemoryReport report;
+		report.EntityCount = (uint32_t)m_Registry.storage<entt::entity>()->free_list();
+
+		const auto* orders = m_Registry.storage<ComponentOrderComponent>();
+		if (!orders)
+			return report;
+
+		report.ComponentOrderCount = (uint32_t)orders->size();
+		report.ComponentOrderBytes = orders->size() * (sizeof(ComponentOrderComponent) + sizeof(entt::entity));
+
+		// Names that don't fit the small string buffer cost a heap allocation each
+		const size_t inlineCapacity = std::string().capacity();
+		for (const ComponentOrderComponent& order : *orders)
+		{
+			size_t bytes = sizeof(std::vector<std::string>) + sizeof(entt::entity) + order.Count * sizeof(std::string);
+			for (uint32_t i = 0; i < order.Count; i++)
 			{
-				auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-				for (auto entity : view)
+				const ComponentMetadata* meta = ComponentRegistry::GetMetadata(order.Order[i]);
+				if (meta && meta->Name.size() > inlineCapacity)
 				{
-					auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
-					Renderer2D::DrawCircle({ .InstanceID = (int)(uint32_t)entity, .Color = circle.Color, .OutlineThickness = circle.OutlineThickness, .Fade = circle.Fade }, transform.GetTransform());
+					bytes += meta->Name.size() + 1;
 				}
 			}
-
-			Renderer2D::EndScene();
+			report.EstimatedNameOrderBytes += bytes;
 		}
+
+		return report;
 	}
 
 	void Scene::OnViewportResize(uint32_t width, uint32_t height)
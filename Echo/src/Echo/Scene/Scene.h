@@ -3,6 +3,10 @@
 #include "Graphics/CommandList.h"
 #include "Graphics/EditorCamera.h"
 
+#include "TransformHierarchy.h"
+#include "SystemScheduler.h"
+#include "SceneSnapshot.h"
+
 #include <entt.hpp>
 
 namespace Echo 
@@ -10,6 +14,19 @@ namespace Echo
 
 	class Physics2D;
 	class Entity;
+	class EntityCommandBuffer;
+	class RetainedQuadBatch;
+
+	struct SceneMemoryReport
+	{
+		uint32_t EntityCount = 0;
+		uint32_t ComponentOrderCount = 0;
+		// Bytes held by the ComponentOrderComponent pool
+		size_t ComponentOrderBytes = 0;
+		// Estimate, not a measurement: what the same orders would take stored as vectors of display name
+		// strings, assuming the standard library's small string buffer
+		size_t EstimatedNameOrderBytes = 0;
+	};
 
 	class Scene 
 	{
@@ -19,14 +36,31 @@ namespace Echo
 
 		static Ref<Scene> Copy(Ref<Scene> srcScene);
 
+		// Scene of entityCount named, transformed sprite entities to benchmark saving and copying with
+		static Ref<Scene> CreateBenchmarkScene(uint32_t entityCount);
+		// Milliseconds to copy a scene of entityCount entities, as entering play mode does. Without bulk
+		// every entity's components are copied one by one through the registry, the way Copy used to
+		static double BenchmarkCopy(uint32_t entityCount = 50000, bool bulk = true);
+
+		// Captures every entity and component so the scene can later be rewound in place.
+		// Restoring while the runtime is running doesn't move physics bodies, restart the runtime around it.
+		Ref<SceneSnapshot> CreateSnapshot();
+		void RestoreSnapshot(const SceneSnapshot& snapshot);
+
 		Entity CreateEntity(const std::string& name = std::string());
 		Entity CreateEntity(const std::string& name, uint64_t uuid);
 		Entity GetEntityByUUID(UUID uuid);
+		Entity TryGetEntityByUUID(UUID uuid);
 		Entity GetPrimaryCameraEntity();
 
 		void DestroyEntity(Entity entity);
 		void DuplicateEntity(Entity entity);
 
+		void SetParent(Entity child, Entity parent);
+		Entity GetParent(Entity entity);
+		bool IsDescendantOf(Entity entity, Entity ancestor);
+		glm::mat4 GetWorldTransform(Entity entity);
+
 		void OnRuntimeStart();
 		void OnRuntimeStop();
 
@@ -35,6 +69,13 @@ namespace Echo
 
 		void OnViewportResize(uint32_t width, uint32_t height);
 
+		// Systems run by OnUpdateRuntime, games can register their own next to the built-in ones
+		SystemScheduler& GetRuntimeSystems() { return m_RuntimeSystems; }
+		// Deferred structural changes, played back after the runtime systems each frame
+		EntityCommandBuffer& GetCommandBuffer() { return *m_CommandBuffer; }
+
+		SceneMemoryReport GetMemoryReport() const;
+
 		uint32_t GetViewportWidth() { return m_ViewportWidth; }
 		uint32_t GetViewportHeight() { return m_ViewportHeight; }
 
@@ -52,6 +93,20 @@ namespace Echo
 	private:
 		template<typename T>
 		void OnComponentAdd(Entity entity, T& component);
+
+		void UpdateWorldTransforms();
+		void RegisterRuntimeSystems();
+		void SubmitRenderables();
+
+		void ConnectRegistrySignals();
+		void OnSpriteChanged(entt::registry& registry, entt::entity entity);
+		void OnSpriteRemoved(entt::registry& registry, entt::entity entity);
+		void OnTransformChanged(entt::registry& registry, entt::entity entity);
+		void SyncSpriteBatch();
+
+		Entity CopyEntityTree(Entity entity, const std::string& name);
+		void LinkChild(Entity parent, Entity child);
+		void UnlinkChild(Entity child);
 	private:
 		entt::registry m_Registry;
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
@@ -59,6 +114,25 @@ namespace Echo
 		Scope<Physics2D> m_Physics2D;
 
 		std::vector<UUID> m_EntityDisplayOrder;
+		std::unordered_map<UUID, entt::entity> m_EntityMap;
+
+		TransformHierarchy m_TransformHierarchy;
+
+		// Sprites stay on the GPU between frames, only entities whose sprite or world transform
+		// changed since the last sync are written again
+		Ref<RetainedQuadBatch> m_SpriteBatch;
+		std::unordered_map<entt::entity, uint32_t> m_SpriteSlots;
+		std::vector<entt::entity> m_DirtySprites;
+		// The dirty sprites still alive and the slots they're written to, kept between syncs
+		std::vector<entt::entity> m_SyncEntities;
+		std::vector<uint32_t> m_SyncSlots;
+		// Cleared when the registry is replaced wholesale, the batch is rebuilt on the next sync
+		bool m_SpriteBatchValid = false;
+
+		SystemScheduler m_RuntimeSystems;
+		Scope<EntityCommandBuffer> m_CommandBuffer;
+		Camera* m_RuntimeCamera = nullptr;
+		glm::mat4 m_RuntimeCameraTransform = glm::mat4(1.0f);
 
 		friend class Entity;
 		friend class SceneSerializer;
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "AssetManager/Asset.h"
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <type_traits>
+
+namespace Echo
+{
+
+	// In-memory binary image of a scene's entities and components, taken with Scene::CreateSnapshot
+	// and applied with Scene::RestoreSnapshot. Trivially copyable component pools are stored as raw
+	// memory, everything else is written field by field. Asset references are kept as live handles,
+	// so a snapshot is only meaningful inside the process that took it.
+	class SceneSnapshot
+	{
+	public:
+		class Writer
+		{
+		public:
+			Writer(SceneSnapshot& snapshot)
+				: m_Snapshot(snapshot)
+			{}
+
+			void WriteBytes(const void* data, size_t size)
+			{
+				if (size == 0)
+					return;
+
+				size_t offset = m_Snapshot.m_Data.size();
+				m_Snapshot.m_Data.resize(offset + size);
+				std::memcpy(m_Snapshot.m_Data.data() + offset, data, size);
+			}
+
+			template<typename T>
+			void Write(const T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written directly!");
+				WriteBytes(&value, sizeof(T));
+			}
+
+			void WriteString(const std::string& value)
+			{
+				Write((uint32_t)value.size());
+				WriteBytes(value.data(), value.size());
+			}
+
+			void WriteAsset(const Ref<Asset>& asset)
+			{
+				if (!asset)
+				{
+					Write(UINT32_MAX);
+					return;
+				}
+
+				Write((uint32_t)m_Snapshot.m_Assets.size());
+				m_Snapshot.m_Assets.push_back(asset);
+			}
+		private:
+			SceneSnapshot& m_Snapshot;
+		};
+
+		class Reader
+		{
+		public:
+			Reader(const SceneSnapshot& snapshot)
+				: m_Snapshot(snapshot)
+			{}
+
+			void ReadBytes(void* data, size_t size)
+			{
+				if (size == 0)
+					return;
+
+				EC_CORE_ASSERT(m_Offset + size <= m_Snapshot.m_Data.size(), "Scene snapshot read out of bounds!");
+				std::memcpy(data, m_Snapshot.m_Data.data() + m_Offset, size);
+				m_Offset += size;
+			}
+
+			template<typename T>
+			T Read()
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read directly!");
+				T value;
+				ReadBytes(&value, sizeof(T));
+				return value;
+			}
+
+			std::string ReadString()
+			{
+				std::string value(Read<uint32_t>(), '\0');
+				ReadBytes(value.data(), value.size());
+				return value;
+			}
+
+			template<typename T>
+			Ref<T> ReadAsset()
+			{
+				uint32_t index = Read<uint32_t>();
+				if (index == UINT32_MAX)
+					return nullptr;
+
+				return std::static_pointer_cast<T>(m_Snapshot.m_Assets[index]);
+			}
+
+			bool IsAtEnd() const { return m_Offset == m_Snapshot.m_Data.size(); }
+		private:
+			const SceneSnapshot& m_Snapshot;
+			size_t m_Offset = 0;
+		};
+	public:
+		SceneSnapshot() = default;
+		~SceneSnapshot() = default;
+
+		size_t GetSize() const { return m_Data.size(); }
+	private:
+		std::vector<uint8_t> m_Data;
+		std::vector<Ref<Asset>> m_Assets;
+	};
+
+}
\ No newline at end of file
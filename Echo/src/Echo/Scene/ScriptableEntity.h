@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
 
 #include "Core/Timestep.h"
 
@@ -13,8 +14,18 @@ namespace Echo
 		virtual ~ScriptableEntity() = default;
 
 		template<typename T>
-		T& GetComponent() { return m_Entity.GetComponent<T>(); }
+		T& GetComponent() 
+		{
+			T& component = m_Entity.GetComponent<T>();
+			// Scripts get a mutable reference, assume the component is about to change
+			if constexpr (std::is_same_v<T, TransformComponent> || std::is_same_v<T, SpriteRendererComponent>)
+				m_Entity.PatchComponent<T>();
+			return component;
+		}
 	protected:
+		// Use instead of creating/destroying entities or adding/removing components directly in OnUpdate
+		EntityCommandBuffer& GetCommandBuffer() { return m_Entity.GetScene()->GetCommandBuffer(); }
+
 		virtual void OnCreate() {}
 		virtual void OnDestroy() {}
 		virtual void OnUpdate(Timestep ts) {}
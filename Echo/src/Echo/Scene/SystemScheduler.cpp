@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "SystemScheduler.h"
+
+namespace Echo
+{
+
+	static bool Intersects(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+	{
+		for (entt::id_type id : a)
+		{
+			if (std::find(b.begin(), b.end(), id) != b.end())
+				return true;
+		}
+		return false;
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (m_Exclusive || other.m_Exclusive)
+			return true;
+
+		return Intersects(m_Writes, other.m_Writes) || Intersects(m_Writes, other.m_Reads) || Intersects(m_Reads, other.m_Writes);
+	}
+
+	void SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function)
+	{
+		SystemNode node;
+		node.Name = name;
+		node.Access = access;
+		node.Function = std::move(function);
+		m_Systems.push_back(std::move(node));
+
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::RemoveSystem(const std::string& name)
+	{
+		auto it = std::remove_if(m_Systems.begin(), m_Systems.end(), [&name](const SystemNode& node) { return node.Name == name; });
+		if (it != m_Systems.end())
+		{
+			m_Systems.erase(it, m_Systems.end());
+			m_GraphDirty = true;
+		}
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		EC_PROFILE_FUNCTION();
+		for (SystemNode& node : m_Systems)
+		{
+			node.Dependents.clear();
+			node.DependencyCount = 0;
+		}
+
+		// A conflicting pair always runs in registration order
+		for (uint32_t j = 0; j < m_Systems.size(); j++)
+		{
+			for (uint32_t i = 0; i < j; i++)
+			{
+				if (m_Systems[i].Access.ConflictsWith(m_Systems[j].Access))
+				{
+					m_Systems[i].Dependents.push_back(j);
+					m_Systems[j].DependencyCount++;
+				}
+			}
+		}
+
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run(SystemContext& context)
+	{
+		EC_PROFILE_FUNCTION();
+		if (m_GraphDirty)
+		{
+			BuildGraph();
+		}
+
+		if (!JobSystem::IsInitialized())
+		{
+			for (uint32_t i = 0; i < (uint32_t)m_Systems.size(); i++)
+			{
+				EC_PROFILE_SCOPE(m_Systems[i].Name.c_str());
+				SystemRecordOrder::Current() = { i + 1, 0 };
+				m_Systems[i].Function(context);
+			}
+			SystemRecordOrder::Current() = {};
+			return;
+		}
+
+		uint32_t count = (uint32_t)m_Systems.size();
+		std::vector<JobCounter> remaining(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			remaining[i].Value.store(m_Systems[i].DependencyCount, std::memory_order_relaxed);
+		}
+
+		auto runSystem = [this, &context, &remaining](uint32_t index)
+		{
+			SystemNode& node = m_Systems[index];
+			{
+				EC_PROFILE_SCOPE(node.Name.c_str());
+				// Saved and restored, the main thread may run this while waiting inside another system
+				SystemRecordOrder previous = SystemRecordOrder::Current();
+				SystemRecordOrder::Current() = { index + 1, 0 };
+				node.Function(context);
+				SystemRecordOrder::Current() = previous;
+			}
+
+			// Through the job system, the dependent may be parked on its counter
+			for (uint32_t dependent : node.Dependents)
+			{
+				JobSystem::Signal(remaining[dependent]);
+			}
+		};
+
+		JobCounter workerSystems;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (!m_Systems[i].Access.IsMainThread())
+			{
+				JobSystem::Execute([&runSystem, i]() { runSystem(i); }, &workerSystems, &remaining[i]);
+			}
+		}
+
+		// Main thread systems run in order, helping with worker systems while their inputs are pending.
+		// Dependencies only point backwards, so this can't deadlock.
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_Systems[i].Access.IsMainThread())
+			{
+				JobSystem::Wait(remaining[i]);
+				runSystem(i);
+			}
+		}
+
+		JobSystem::Wait(workerSystems);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Core/Timestep.h"
+#include "Core/JobSystem.h"
+
+#include <entt.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace Echo
+{
+
+	class Scene;
+	class CommandList;
+	class EntityCommandBuffer;
+
+	// Declares which components (or any other shared state, identified by type) a system touches.
+	// Systems whose accesses don't conflict are run in parallel.
+	class SystemAccess
+	{
+	public:
+		template<typename... T>
+		SystemAccess& Read() { (m_Reads.push_back(entt::type_hash<T>::value()), ...); return *this; }
+
+		template<typename... T>
+		SystemAccess& Write() { (m_Writes.push_back(entt::type_hash<T>::value()), ...); return *this; }
+
+		// Must run on the main thread (renderer submission, ImGui, ...)
+		SystemAccess& MainThread() { m_MainThread = true; return *this; }
+		// May touch anything, including structural changes; never overlaps with another system
+		SystemAccess& Exclusive() { m_Exclusive = true; return *this; }
+
+		bool ConflictsWith(const SystemAccess& other) const;
+		bool IsMainThread() const { return m_MainThread || m_Exclusive; }
+	private:
+		std::vector<entt::id_type> m_Reads;
+		std::vector<entt::id_type> m_Writes;
+		bool m_MainThread = false;
+		bool m_Exclusive = false;
+	};
+
+	// Where the calling thread is inside SystemScheduler::Run, the running system (0 outside of any) and the
+	// position within it, which ParallelEach advances per entity chunk. Commands recorded into the
+	// EntityCommandBuffer are played back in this order, not in the order workers happened to run
+	struct SystemRecordOrder
+	{
+		uint32_t System = 0;
+		uint32_t Position = 0;
+
+		static SystemRecordOrder& Current()
+		{
+			static thread_local SystemRecordOrder s_Current;
+			return s_Current;
+		}
+	};
+
+	struct SystemContext
+	{
+		Scene* ActiveScene = nullptr;
+		entt::registry* Registry = nullptr;
+		CommandList* Commands = nullptr;
+		// Structural changes must go through here while systems are running
+		EntityCommandBuffer* EntityCommands = nullptr;
+		Timestep TS;
+
+		// Runs function(entity) for every entity in the view, split into chunks across the job system
+		template<typename... Components, typename Function>
+		void ParallelEach(Function&& function, uint32_t grainSize = 1024)
+		{
+			auto view = Registry->view<Components...>();
+			const auto* storage = view.handle();
+			if (!storage)
+				return;
+
+			const entt::entity* entities = storage->data();
+			uint32_t count = (uint32_t)storage->size();
+			SystemRecordOrder order = SystemRecordOrder::Current();
+			JobSystem::ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end)
+			{
+				SystemRecordOrder previous = SystemRecordOrder::Current();
+				SystemRecordOrder::Current() = { order.System, order.Position + 1 + begin };
+				for (uint32_t i = begin; i < end; i++)
+				{
+					if (view.contains(entities[i]))
+						function(entities[i]);
+				}
+				SystemRecordOrder::Current() = previous;
+			});
+			// Whatever the system records afterwards comes after every chunk
+			SystemRecordOrder::Current().Position = order.Position + 1 + count;
+		}
+	};
+
+	using SystemFunction = std::function<void(SystemContext&)>;
+
+	class SystemScheduler
+	{
+	public:
+		SystemScheduler() = default;
+		~SystemScheduler() = default;
+
+		// Systems that conflict keep their registration order
+		void AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function);
+		void RemoveSystem(const std::string& name);
+
+		void Run(SystemContext& context);
+	private:
+		void BuildGraph();
+	private:
+		struct SystemNode
+		{
+			std::string Name;
+			SystemAccess Access;
+			SystemFunction Function;
+
+			std::vector<uint32_t> Dependents;
+			uint32_t DependencyCount = 0;
+		};
+
+		std::vector<SystemNode> m_Systems;
+		bool m_GraphDirty = true;
+	};
+
+}
\ No newline at end of file
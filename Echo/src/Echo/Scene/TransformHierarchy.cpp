@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "TransformHierarchy.h"
+
+#include "Components.h"
+
+#include "Core/JobSystem.h"
+
+namespace Echo
+{
+
+	void TransformHierarchy::MarkDirty(entt::entity entity)
+	{
+		// A pending rebuild refreshes everything anyway
+		if (m_StructureDirty)
+			return;
+
+		uint32_t entityIndex = entt::to_entity(entity);
+		if (entityIndex >= m_IndexOf.size() || m_IndexOf[entityIndex] < 0)
+			return;
+
+		uint32_t index = (uint32_t)m_IndexOf[entityIndex];
+		if (m_Entities[index] != entity)
+			return;
+
+		// Physics sync patches transforms from job system workers, the flag keeps each index listed once
+		if (std::atomic_ref<uint8_t>(m_Changed[index]).exchange(1) == 0)
+			m_DirtyIndices[m_DirtyCount.fetch_add(1)] = index;
+	}
+
+	void TransformHierarchy::Update(entt::registry& registry, const std::unordered_map<UUID, entt::entity>& entityMap)
+	{
+		EC_PROFILE_FUNCTION();
+		if (m_StructureDirty)
+		{
+			Rebuild(registry, entityMap);
+		}
+
+		m_UpdatedIndices.clear();
+		m_UpdatedEntities.clear();
+
+		uint32_t dirtyCount = m_DirtyCount.exchange(0);
+		if (dirtyCount == 0)
+			return;
+
+		// Level order, so each level's dirty entities are one run of the list
+		std::sort(m_DirtyIndices.begin(), m_DirtyIndices.begin() + dirtyCount);
+		JobSystem::ParallelFor(dirtyCount, 1024, [this, &registry](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				uint32_t index = m_DirtyIndices[i];
+				m_LocalTransforms[index] = registry.get<TransformComponent>(m_Entities[index]).GetTransform();
+			}
+		});
+
+		// A level holds the children of whatever the level before updated plus its own dirty entities.
+		// Each level only reads the one before it, small levels run inline on the calling thread
+		uint32_t begin = 0;
+		uint32_t nextDirty = 0;
+		for (const LevelRange& level : m_Levels)
+		{
+			while (nextDirty < dirtyCount && m_DirtyIndices[nextDirty] < level.End)
+				m_UpdatedIndices.push_back(m_DirtyIndices[nextDirty++]);
+
+			uint32_t end = (uint32_t)m_UpdatedIndices.size();
+			if (begin == end)
+			{
+				if (nextDirty == dirtyCount)
+					break;
+
+				continue;
+			}
+
+			JobSystem::ParallelFor(end - begin, 1024, [this, begin](uint32_t first, uint32_t last)
+			{
+				Propagate(begin + first, begin + last);
+			});
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				uint32_t index = m_UpdatedIndices[i];
+				uint32_t childEnd = m_FirstChild[index] + m_ChildCount[index];
+				for (uint32_t child = m_FirstChild[index]; child < childEnd; child++)
+				{
+					if (m_Changed[child])
+						continue;
+
+					m_Changed[child] = 1;
+					m_UpdatedIndices.push_back(child);
+				}
+			}
+			begin = end;
+		}
+
+		m_UpdatedEntities.reserve(m_UpdatedIndices.size());
+		for (uint32_t index : m_UpdatedIndices)
+		{
+			registry.get<WorldTransformComponent>(m_Entities[index]).Transform = m_WorldTransforms[index];
+			m_UpdatedEntities.push_back(m_Entities[index]);
+			m_Changed[index] = 0;
+		}
+	}
+
+	void TransformHierarchy::Propagate(uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			uint32_t index = m_UpdatedIndices[i];
+			int32_t parent = m_ParentIndices[index];
+			m_WorldTransforms[index] = parent >= 0 ? m_WorldTransforms[parent] * m_LocalTransforms[index] : m_LocalTransforms[index];
+		}
+	}
+
+	void TransformHierarchy::Rebuild(entt::registry& registry, const std::unordered_map<UUID, entt::entity>& entityMap)
+	{
+		EC_PROFILE_FUNCTION();
+		m_Entities.clear();
+		m_ParentIndices.clear();
+		m_FirstChild.clear();
+		m_ChildCount.clear();
+		m_Levels.clear();
+
+		auto view = registry.view<TransformComponent, WorldTransformComponent>();
+		m_Entities.reserve(view.size_hint());
+		m_ParentIndices.reserve(view.size_hint());
+
+		// Also guards against placing an entity twice when the links are inconsistent
+		m_IndexOf.assign(registry.storage<entt::entity>().size(), -1);
+		uint32_t entityCount = 0;
+
+		auto isValid = [&](UUID uuid, entt::entity& outEntity)
+		{
+			auto it = entityMap.find(uuid);
+			if (it == entityMap.end() || !view.contains(it->second))
+				return false;
+
+			outEntity = it->second;
+			return true;
+		};
+
+		auto place = [&](entt::entity entity, int32_t parentIndex)
+		{
+			m_IndexOf[entt::to_entity(entity)] = (int32_t)m_Entities.size();
+			m_Entities.push_back(entity);
+			m_ParentIndices.push_back(parentIndex);
+			m_FirstChild.push_back(0);
+			m_ChildCount.push_back(0);
+		};
+
+		// Breadth first walk from the roots already placed at [begin, end), appending one level at a time so
+		// the children of an entity end up next to each other. Only children that point back at the parent
+		// listing them are followed
+		auto placeDescendants = [&](uint32_t begin)
+		{
+			while (begin < (uint32_t)m_Entities.size())
+			{
+				uint32_t end = (uint32_t)m_Entities.size();
+				m_Levels.push_back({ begin, end });
+
+				for (uint32_t i = begin; i < end; i++)
+				{
+					m_FirstChild[i] = (uint32_t)m_Entities.size();
+					auto* rc = registry.try_get<RelationshipComponent>(m_Entities[i]);
+					if (!rc)
+						continue;
+
+					UUID parentID = registry.get<IDComponent>(m_Entities[i]).ID;
+					for (UUID childID : rc->Children)
+					{
+						entt::entity child;
+						if (!isValid(childID, child) || m_IndexOf[entt::to_entity(child)] >= 0)
+							continue;
+
+						auto* childRc = registry.try_get<RelationshipComponent>(child);
+						if (!childRc || childRc->Parent != parentID)
+							continue;
+
+						place(child, (int32_t)i);
+					}
+					m_ChildCount[i] = (uint32_t)m_Entities.size() - m_FirstChild[i];
+				}
+
+				begin = end;
+			}
+		};
+
+		for (auto entity : view)
+		{
+			entityCount++;
+
+			entt::entity parentEntity;
+			auto* relationship = registry.try_get<RelationshipComponent>(entity);
+			if (relationship && relationship->Parent != 0 && isValid(relationship->Parent, parentEntity))
+				continue;
+
+			place(entity, -1);
+		}
+		placeDescendants(0);
+
+		// Whatever is left has a parent that doesn't list it as a child, or sits in a parent cycle.
+		// Those are treated as roots so they keep being transformed instead of silently disappearing
+		while ((uint32_t)m_Entities.size() < entityCount)
+		{
+			uint32_t begin = (uint32_t)m_Entities.size();
+			for (auto entity : view)
+			{
+				if (m_IndexOf[entt::to_entity(entity)] >= 0)
+					continue;
+
+				const auto& relationship = registry.get<RelationshipComponent>(entity);
+				entt::entity parentEntity = entt::null;
+				isValid(relationship.Parent, parentEntity);
+				const auto* parentRc = registry.try_get<RelationshipComponent>(parentEntity);
+				UUID id = registry.get<IDComponent>(entity).ID;
+				if (!parentRc || std::find(parentRc->Children.begin(), parentRc->Children.end(), id) == parentRc->Children.end())
+				{
+					EC_CORE_WARN("Entity {0} isn't listed as a child of its parent, treating it as a root", (uint64_t)id);
+					place(entity, -1);
+				}
+			}
+
+			// Only cycles left, break one at an arbitrary entity
+			if ((uint32_t)m_Entities.size() == begin)
+			{
+				for (auto entity : view)
+				{
+					if (m_IndexOf[entt::to_entity(entity)] < 0)
+					{
+						EC_CORE_WARN("Entity {0} is part of a parent cycle, treating it as a root", (uint64_t)registry.get<IDComponent>(entity).ID);
+						place(entity, -1);
+						break;
+					}
+				}
+			}
+
+			placeDescendants(begin);
+		}
+
+		// Everything counts as dirty after a rebuild
+		uint32_t count = (uint32_t)m_Entities.size();
+		m_LocalTransforms.resize(count);
+		m_WorldTransforms.resize(count);
+		m_Changed.assign(count, 1);
+		m_DirtyIndices.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+			m_DirtyIndices[i] = i;
+		m_DirtyCount = count;
+
+		m_StructureDirty = false;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Core/UUID.h"
+
+#include <entt.hpp>
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+namespace Echo
+{
+
+	// Flattened parent/child transform data stored level by level, every entity of a level comes
+	// after its parent in the level before and siblings are contiguous. Only entities marked dirty
+	// and their descendants are visited, one level at a time so a level can be split across threads.
+	class TransformHierarchy
+	{
+	public:
+		struct LevelRange
+		{
+			uint32_t Begin;
+			uint32_t End;
+		};
+	public:
+		TransformHierarchy() = default;
+		~TransformHierarchy() = default;
+
+		void Invalidate() { m_StructureDirty = true; }
+
+		// Queues the entity's local matrix for the next Update. Safe to call from several threads at once,
+		// as long as nothing updates or rebuilds the hierarchy meanwhile
+		void MarkDirty(entt::entity entity);
+
+		// Rebuilds the layout if needed, then refreshes local/world matrices of dirty entities and their
+		// descendants and writes the results to WorldTransformComponent.
+		void Update(entt::registry& registry, const std::unordered_map<UUID, entt::entity>& entityMap);
+
+		// Entities whose world matrix was rewritten by the last Update
+		const std::vector<entt::entity>& GetUpdatedEntities() const { return m_UpdatedEntities; }
+
+		const std::vector<LevelRange>& GetLevelRanges() const { return m_Levels; }
+		uint32_t GetSize() const { return (uint32_t)m_Entities.size(); }
+	private:
+		void Rebuild(entt::registry& registry, const std::unordered_map<UUID, entt::entity>& entityMap);
+
+		// Propagates world matrices for m_UpdatedIndices[begin, end), which must lie within one level.
+		// Entities of a level never depend on each other once the levels before it are done.
+		void Propagate(uint32_t begin, uint32_t end);
+	private:
+		std::vector<entt::entity> m_Entities;
+		std::vector<int32_t> m_ParentIndices;
+		std::vector<uint32_t> m_FirstChild;
+		std::vector<uint32_t> m_ChildCount;
+		std::vector<glm::mat4> m_LocalTransforms;
+		std::vector<glm::mat4> m_WorldTransforms;
+		// Indexed by entity index, -1 for entities that aren't part of the hierarchy
+		std::vector<int32_t> m_IndexOf;
+
+		// Set while an index is listed in m_DirtyIndices or m_UpdatedIndices
+		std::vector<uint8_t> m_Changed;
+		// Sized for every entity up front so MarkDirty only has to bump the count
+		std::vector<uint32_t> m_DirtyIndices;
+		std::atomic<uint32_t> m_DirtyCount = 0;
+		// Indices visited by the last Update, grouped by level
+		std::vector<uint32_t> m_UpdatedIndices;
+		std::vector<entt::entity> m_UpdatedEntities;
+
+		std::vector<LevelRange> m_Levels;
+
+		bool m_StructureDirty = true;
+	};
+
+}
\ No newline at end of file
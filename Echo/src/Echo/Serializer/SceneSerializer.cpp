@@ -10,6 +10,7 @@
 
 #include <yaml-cpp/yaml.h>
 #include <fstream>
+#include <chrono>
 
 namespace YAML
 {
@@ -96,6 +97,13 @@ namespace Echo
 	}
 
 	void SceneSerializer::Serialize(const std::string& filepath)
+	{
+		EC_PROFILE_FUNCTION();
+		std::ofstream fout(filepath);
+		fout << SerializeToString();
+	}
+
+	std::string SceneSerializer::SerializeToString()
 	{
 		EC_PROFILE_FUNCTION();
 
@@ -112,7 +120,7 @@ namespace Echo
 		out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
 		for (const UUID& entityUUID : m_Scene->GetEntityDisplayOrder())
 		{
-			Entity entity = m_Scene->GetEntityByUUID(entityUUID);
+			Entity entity = m_Scene->TryGetEntityByUUID(entityUUID);
 			if (entity)
 			{
 				SerializeEntity(out, entity);
@@ -121,8 +129,20 @@ namespace Echo
 		out << YAML::EndSeq;
 
 		out << YAML::EndMap;
-		std::ofstream fout(filepath);
-		fout << out.c_str();
+		return std::string(out.c_str(), out.size());
+	}
+
+	double SceneSerializer::Benchmark(uint32_t entityCount)
+	{
+		EC_PROFILE_FUNCTION();
+		SceneSerializer serializer(Scene::CreateBenchmarkScene(entityCount));
+
+		auto start = std::chrono::high_resolution_clock::now();
+		std::string yaml = serializer.SerializeToString();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		EC_CORE_ASSERT(!yaml.empty(), "Scene serialized to nothing!");
+		return std::chrono::duration<double, std::milli>(end - start).count();
 	}
 
 	void SceneSerializer::SerializeRuntime(const std::string& filepath)
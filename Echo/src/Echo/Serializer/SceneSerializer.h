@@ -13,10 +13,15 @@ namespace Echo
 		{}
 
 		void Serialize(const std::string& filepath);
+		// The YAML Serialize writes, without touching the disk
+		std::string SerializeToString();
 		void SerializeRuntime(const std::string& filepath);
 
 		bool Deserialize(const std::string& filepath);
 		bool DeserializeRuntime(const std::string& filepath);
+
+		// Milliseconds to serialize a scene of entityCount entities to YAML
+		static double Benchmark(uint32_t entityCount = 50000);
 	private:
 		Ref<Scene> m_Scene;
 	};
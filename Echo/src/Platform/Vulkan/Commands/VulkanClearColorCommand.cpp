@@ -9,36 +9,37 @@
 namespace Echo
 {
 
-	void VulkanClearColorCommand::Execute(CommandBuffer* cmd)
+	void VulkanClearColorCommand::Execute(VulkanCommandBuffer* cmd, const ClearColorPacket& packet)
 	{
 		EC_PROFILE_FUNCTION();
-		VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)cmd)->GetCommandBuffer();
-		VulkanFramebuffer* fb = (VulkanFramebuffer*)m_Framebuffer.get();
+		VkCommandBuffer commandBuffer = cmd->GetCommandBuffer();
+		VulkanFramebuffer* fb = (VulkanFramebuffer*)packet.Target;
+		const glm::vec4& clearValues = packet.ClearValues;
 
-		if (fb->GetCurrentLayout(m_Index) != VK_IMAGE_LAYOUT_GENERAL) 
+		if (fb->GetCurrentLayout(packet.Index) != VK_IMAGE_LAYOUT_GENERAL) 
 		{
-			fb->TransitionImageLayout(commandBuffer, m_Index, VK_IMAGE_LAYOUT_GENERAL);
+			fb->TransitionImageLayout(commandBuffer, packet.Index, VK_IMAGE_LAYOUT_GENERAL);
 		}
 
-		bool shouldInt = fb->GetImage(m_Index).ImageFormat == VK_FORMAT_R32_SINT;
+		bool shouldInt = fb->GetImage(packet.Index).ImageFormat == VK_FORMAT_R32_SINT;
 
 		VkClearColorValue clearValue;
 		if (shouldInt)
 		{
-			clearValue.int32[0] = (int32_t)m_ClearValues.r;
-			clearValue.int32[1] = (int32_t)m_ClearValues.g;
-			clearValue.int32[2] = (int32_t)m_ClearValues.b;
-			clearValue.int32[3] = (int32_t)m_ClearValues.a;
+			clearValue.int32[0] = (int32_t)clearValues.r;
+			clearValue.int32[1] = (int32_t)clearValues.g;
+			clearValue.int32[2] = (int32_t)clearValues.b;
+			clearValue.int32[3] = (int32_t)clearValues.a;
 		}
 		else
 		{
-			clearValue.float32[0] = m_ClearValues.r;
-			clearValue.float32[1] = m_ClearValues.g;
-			clearValue.float32[2] = m_ClearValues.b;
-			clearValue.float32[3] = m_ClearValues.a;
+			clearValue.float32[0] = clearValues.r;
+			clearValue.float32[1] = clearValues.g;
+			clearValue.float32[2] = clearValues.b;
+			clearValue.float32[3] = clearValues.a;
 		}
 		VkImageSubresourceRange subresourceRange = VulkanInitializers::ImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT);
 
-		vkCmdClearColorImage(commandBuffer, fb->GetImage(m_Index).Image, VK_IMAGE_LAYOUT_GENERAL, &clearValue, 1, &subresourceRange);
+		vkCmdClearColorImage(commandBuffer, fb->GetImage(packet.Index).Image, VK_IMAGE_LAYOUT_GENERAL, &clearValue, 1, &subresourceRange);
 	}
 }
\ No newline at end of file
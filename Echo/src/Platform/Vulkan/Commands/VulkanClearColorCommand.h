@@ -1,25 +1,16 @@
 #pragma once
 
-#include "Graphics/Commands/ICommand.h"
-#include "Graphics/Primitives/Framebuffer.h"
-
-#include <glm/glm.hpp>
+#include "Graphics/Commands/CommandStream.h"
 
 namespace Echo 
 {
 
-	class VulkanClearColorCommand : public ICommand
+	class VulkanCommandBuffer;
+
+	class VulkanClearColorCommand
 	{
 	public:
-		VulkanClearColorCommand(Ref<Framebuffer> framebuffer, uint32_t index, const glm::vec4& clearValues)
-			: m_ClearValues(clearValues), m_Framebuffer(framebuffer), m_Index(index)
-		{}
-
-		virtual void Execute(CommandBuffer* cmd) override;
-	private:
-		const glm::vec4 m_ClearValues;
-		Ref<Framebuffer> m_Framebuffer;
-		uint32_t m_Index;
+		static void Execute(VulkanCommandBuffer* cmd, const ClearColorPacket& packet);
 	};
 
 }
\ No newline at end of file
@@ -2,27 +2,19 @@
 
 #include "Vulkan/Primitives/VulkanCommandBuffer.h"
 
-#include "Graphics/Primitives/CommandBuffer.h"
-#include "Graphics/Commands/ICommand.h"
-
 #include <backends/imgui_impl_vulkan.h>
 #include <imgui.h>
 
 namespace Echo
 {
 
-	class VulkanRenderImGuiCommand : public ICommand
+	class VulkanRenderImGuiCommand
 	{
 	public:
-		VulkanRenderImGuiCommand() = default;
-
-		void Execute(CommandBuffer* cmd) override
+		static void Execute(VulkanCommandBuffer* cmd)
 		{
-			VulkanCommandBuffer* vulkanCmd = (VulkanCommandBuffer*)cmd;
-			VkCommandBuffer commandBuffer = vulkanCmd->GetCommandBuffer();
-
 			ImGui::Render();
-			ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+			ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd->GetCommandBuffer());
 		}
 	};
 
@@ -5,6 +5,7 @@
 #include "Vulkan/Primitives/VulkanFramebuffer.h"
 #include "Vulkan/Primitives/VulkanDevice.h"
 #include "Vulkan/VulkanSwapchain.h"
+#include "Vulkan/VulkanRenderCaps.h"
 
 #include "Vulkan/Utils/VulkanInitializers.h"
 #include "Core/Application.h"
@@ -12,11 +13,42 @@
 namespace Echo
 {
 
-	void VulkanBeginRenderingCommand::Execute(CommandBuffer* cmd)
+	void VulkanBeginRenderingCommand::Execute(VulkanCommandBuffer* cmd, const BeginRenderingPacket& packet)
 	{
 		EC_PROFILE_FUNCTION();
-		VulkanCommandBuffer* commandBuffer = ((VulkanCommandBuffer*)cmd);
-		VulkanFramebuffer* fb = (VulkanFramebuffer*)m_Framebuffer.get();
+		RenderingInheritance inheritance;
+		if (Begin(cmd, packet, 0, inheritance))
+			SetViewport(cmd->GetCommandBuffer(), inheritance.Extent);
+	}
+
+	bool VulkanBeginRenderingCommand::ExecuteSecondary(VulkanCommandBuffer* cmd, const BeginRenderingPacket& packet, RenderingInheritance& inheritance)
+	{
+		EC_PROFILE_FUNCTION();
+		return Begin(cmd, packet, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT, inheritance);
+	}
+
+	void VulkanBeginRenderingCommand::SetViewport(VkCommandBuffer cmd, VkExtent2D extent)
+	{
+		VkViewport viewport = {};
+		viewport.x = 0;
+		viewport.y = 0;
+		viewport.width = extent.width;
+		viewport.height = extent.height;
+		viewport.minDepth = 0.f;
+		viewport.maxDepth = 1.f;
+		vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+		VkRect2D scissor = {};
+		scissor.offset.x = 0;
+		scissor.offset.y = 0;
+		scissor.extent.width = extent.width;
+		scissor.extent.height = extent.height;
+		vkCmdSetScissor(cmd, 0, 1, &scissor);
+	}
+
+	bool VulkanBeginRenderingCommand::Begin(VulkanCommandBuffer* commandBuffer, const BeginRenderingPacket& packet, VkRenderingFlags flags, RenderingInheritance& inheritance)
+	{
+		VulkanFramebuffer* fb = (VulkanFramebuffer*)packet.Target;
 		VulkanDevice* device = (VulkanDevice*)Application::Get().GetWindow().GetDevice();
 		VkRenderingAttachmentInfo depthAttachmentInfo = {}; 
 		VkRenderingAttachmentInfo* depthAttachment = nullptr;
@@ -24,10 +56,10 @@ namespace Echo
 		VkRenderingInfo renderingInfo = {};
 		VkExtent2D extent;
 
-		if (fb == nullptr && !((VulkanCommandBuffer*)cmd)->DrawToSwapchain())
+		if (fb == nullptr && !commandBuffer->DrawToSwapchain())
 		{
 			EC_CORE_ERROR("No image set for rendering!");
-			return;
+			return false;
 		}
 		else if (fb)
 		{
@@ -47,6 +79,7 @@ namespace Echo
 					}
 
 					depthAttachment = &depthAttachmentInfo;
+					inheritance.DepthFormat = fb->GetImage(i).ImageFormat;
 				}
 				else
 				{
@@ -54,41 +87,24 @@ namespace Echo
 						fb->TransitionImageLayout(commandBuffer->GetCommandBuffer(), i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
 					colorAttachments.push_back(VulkanInitializers::AttachmentInfo(fb->GetImage(i).ImageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL));
+					inheritance.ColorFormats.push_back(fb->GetImage(i).ImageFormat);
 				}
 			}
 			renderingInfo = VulkanInitializers::RenderingInfo(extent, colorAttachments, depthAttachment);
+			inheritance.Samples = fb->IsUsingSamples() ? VulkanRenderCaps::GetSampleCount() : VK_SAMPLE_COUNT_1_BIT;
 		}
 		else
 		{
 			extent = device->GetSwapchain().GetExtent();
 			colorAttachments.push_back(VulkanInitializers::AttachmentInfo(device->GetSwapchainImageView(commandBuffer->GetImageIndex()), nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL));
 			renderingInfo = VulkanInitializers::RenderingInfo(device->GetSwapchain().GetExtent(), colorAttachments, nullptr);
+			inheritance.ColorFormats.push_back(device->GetSwapchain().GetFormat());
 		}
+		renderingInfo.flags = flags;
 
 		vkCmdBeginRendering(commandBuffer->GetCommandBuffer(), &renderingInfo);
-
-		VkViewport viewport = {};
-		viewport.x = 0;
-		viewport.y = 0;
-		viewport.width = extent.width;
-		viewport.height = extent.height;
-		viewport.minDepth = 0.f;
-		viewport.maxDepth = 1.f;
-		vkCmdSetViewport(commandBuffer->GetCommandBuffer(), 0, 1, &viewport);
-
-		VkRect2D scissor = {};
-		scissor.offset.x = 0;
-		scissor.offset.y = 0;
-		scissor.extent.width = extent.width;
-		scissor.extent.height = extent.height;
-		vkCmdSetScissor(commandBuffer->GetCommandBuffer(), 0, 1, &scissor);
-	}
-
-	void VulkanEndRenderingCommand::Execute(CommandBuffer* cmd)
-	{
-		EC_PROFILE_FUNCTION();
-		VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)cmd)->GetCommandBuffer();
-		vkCmdEndRendering(commandBuffer);
+		inheritance.Extent = extent;
+		return true;
 	}
 
 }	
\ No newline at end of file
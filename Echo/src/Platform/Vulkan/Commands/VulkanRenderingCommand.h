@@ -1,34 +1,36 @@
 #pragma once
 
-#include "Graphics/Primitives/CommandBuffer.h"
-#include "Graphics/Commands/ICommand.h"
+#include "Graphics/Commands/CommandStream.h"
 
-#include "Graphics/Primitives/Framebuffer.h"
-
-#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <vector>
 
 namespace Echo 
 {
 
-	class VulkanBeginRenderingCommand : public ICommand
-	{
-	public:
-		VulkanBeginRenderingCommand(Ref<Framebuffer> framebuffer)
-			: m_Framebuffer(framebuffer)
-		{}
-		VulkanBeginRenderingCommand() = default;
+	class VulkanCommandBuffer;
 
-		virtual void Execute(CommandBuffer* cmd) override;
-	private:
-		Ref<Framebuffer> m_Framebuffer = nullptr;
-		std::vector<uint32_t> m_Indexes;
+	// What secondary command buffers recording into a rendering have to be begun with
+	struct RenderingInheritance
+	{
+		std::vector<VkFormat> ColorFormats;
+		VkFormat DepthFormat = VK_FORMAT_UNDEFINED;
+		VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+		VkExtent2D Extent{};
 	};
 
-	class VulkanEndRenderingCommand : public ICommand
+	class VulkanBeginRenderingCommand
 	{
 	public:
-		VulkanEndRenderingCommand() = default;
-		virtual void Execute(CommandBuffer* cmd) override;
+		static void Execute(VulkanCommandBuffer* cmd, const BeginRenderingPacket& packet);
+		// Begins a rendering whose contents are all recorded in secondary command buffers. Returns false
+		// if there is nothing to render to
+		static bool ExecuteSecondary(VulkanCommandBuffer* cmd, const BeginRenderingPacket& packet, RenderingInheritance& inheritance);
+
+		// Full extent viewport and scissor. Secondary command buffers don't inherit them from the primary
+		static void SetViewport(VkCommandBuffer cmd, VkExtent2D extent);
+	private:
+		static bool Begin(VulkanCommandBuffer* cmd, const BeginRenderingPacket& packet, VkRenderingFlags flags, RenderingInheritance& inheritance);
 	};
 
 }
\ No newline at end of file
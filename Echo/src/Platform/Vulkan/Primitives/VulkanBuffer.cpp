@@ -22,14 +22,17 @@ namespace Echo
 
 	VulkanVertexBuffer::~VulkanVertexBuffer()
 	{
-		m_Device->DestroyBuffer(m_Buffer);
+		m_Device->RetireBuffer(m_Buffer);
 	}
 
 	void VulkanVertexBuffer::Bind(CommandBuffer* cmd)
 	{
 		EC_PROFILE_FUNCTION();
-		VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)cmd)->GetCommandBuffer();
+		RecordBind(((VulkanCommandBuffer*)cmd)->GetCommandBuffer());
+	}
 
+	void VulkanVertexBuffer::RecordBind(VkCommandBuffer commandBuffer)
+	{
 		VkBuffer vertexBuffers[] = { m_Buffer.Buffer };
 		VkDeviceSize offsets[] = { 0 };
 		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
@@ -38,71 +41,221 @@ namespace Echo
 	void VulkanVertexBuffer::SetData(void* data, uint32_t size)
 	{
 		EC_PROFILE_FUNCTION();
-		VkMemoryRequirements memReqs;
-		vkGetBufferMemoryRequirements(m_Device->GetDevice(), m_Buffer.Buffer, &memReqs);
+		// Frames in flight may still be reading the buffer and uploads don't wait for them, so the data
+		// goes into a fresh buffer and the old one is destroyed once those frames are done
+		if (size == 0)
+			return;
 
-		if (size > memReqs.size)
-		{
-			AllocatedBuffer oldBuffer = m_Buffer;
+		m_Device->RetireBuffer(m_Buffer);
+		CreateBuffer((float*)data, size, m_IsDynamic);
+	}
+
+	void VulkanVertexBuffer::CreateBuffer(float* data, uint32_t size, bool isDynamic)
+	{
+		EC_PROFILE_FUNCTION();
+		m_IsDynamic = isDynamic;
+		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+										  isDynamic ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_TO_GPU);
 
-			VkBufferUsageFlags usageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-				VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-				VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
-			m_Buffer = m_Device->CreateBuffer(size, usageFlags, VMA_MEMORY_USAGE_GPU_ONLY);
+		m_Device->GetUploadManager()->UploadBuffer(m_Buffer.Buffer, 0, data, size);
+	}
 
-			m_Device->DestroyBuffer(oldBuffer);
+	void VulkanVertexBuffer::CreateBuffer(uint32_t size, bool isDynamic)
+	{
+		m_IsDynamic = isDynamic;
+		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+										  isDynamic ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_TO_GPU);
+	}
+
+	VulkanStreamingVertexBuffer::VulkanStreamingVertexBuffer(Device* device, uint32_t blockSize)
+		: m_Device((VulkanDevice*)device), m_BlockSize(blockSize)
+	{
+	}
+
+	VulkanStreamingVertexBuffer::~VulkanStreamingVertexBuffer()
+	{
+		for (FrameBlocks& frame : m_Frames)
+		{
+			for (Block& block : frame.Blocks)
+			{
+				m_Device->RetireBuffer(block.Buffer);
+			}
 		}
+	}
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(
-			size,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VMA_MEMORY_USAGE_CPU_ONLY
-		);
+	VulkanStreamingVertexBuffer::FrameBlocks& VulkanStreamingVertexBuffer::GetCurrentFrame()
+	{
+		FrameBlocks& frame = m_Frames[m_Device->GetFrameIndex()];
+		if (frame.FrameCount != m_Device->GetFrameCount())
+		{
+			// First use since this frame slot was last in flight, everything in it is free again
+			frame.FrameCount = m_Device->GetFrameCount();
+			frame.CurrentBlock = 0;
+			frame.Cursor = 0;
+		}
+		return frame;
+	}
 
-		void* mappedData = m_Device->GetMappedData(staging);
-		memcpy(mappedData, data, size);
+	StreamingAllocation VulkanStreamingVertexBuffer::Allocate(uint32_t size)
+	{
+		EC_PROFILE_FUNCTION();
+		FrameBlocks& frame = GetCurrentFrame();
+
+		// Vertex attributes are at most 16 bytes wide
+		VkDeviceSize offset = (frame.Cursor + 15) & ~(VkDeviceSize)15;
+		while (frame.CurrentBlock < frame.Blocks.size() && offset + size > frame.Blocks[frame.CurrentBlock].Size)
+		{
+			frame.CurrentBlock++;
+			offset = 0;
+		}
 
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+		if (frame.CurrentBlock == frame.Blocks.size())
 		{
-			VkBufferCopy copy{};
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = size;
+			// Coherent so CPU writes never need an explicit flush
+			Block block{};
+			block.Size = std::max(m_BlockSize, (VkDeviceSize)size);
+			block.Buffer = m_Device->CreateBuffer(block.Size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU,
+												  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			block.MappedData = (uint8_t*)m_Device->GetMappedData(block.Buffer);
+			frame.Blocks.push_back(block);
+		}
 
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
+		frame.Cursor = offset + size;
 
-		m_Device->DestroyBuffer(staging);
+		StreamingAllocation allocation{};
+		allocation.Data = frame.Blocks[frame.CurrentBlock].MappedData + offset;
+		allocation.Size = size;
+		allocation.Block = frame.CurrentBlock;
+		allocation.Offset = offset;
+		return allocation;
 	}
 
-	void VulkanVertexBuffer::CreateBuffer(float* data, uint32_t size, bool isDynamic)
+	void VulkanStreamingVertexBuffer::Trim(StreamingAllocation& allocation, uint32_t usedSize)
+	{
+		EC_CORE_ASSERT(usedSize <= allocation.Size, "Streaming allocation overflow!");
+		FrameBlocks& frame = GetCurrentFrame();
+		if (allocation.Block == frame.CurrentBlock && allocation.Offset + allocation.Size == frame.Cursor)
+		{
+			frame.Cursor = allocation.Offset + usedSize;
+			allocation.Size = usedSize;
+		}
+	}
+
+	void VulkanStreamingVertexBuffer::Bind(CommandBuffer* cmd, const StreamingAllocation& allocation)
 	{
 		EC_PROFILE_FUNCTION();
-		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-										  isDynamic ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_TO_GPU);
+		RecordBind(((VulkanCommandBuffer*)cmd)->GetCommandBuffer(), allocation);
+	}
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* mappedData = m_Device->GetMappedData(staging);
+	void VulkanStreamingVertexBuffer::RecordBind(VkCommandBuffer commandBuffer, const StreamingAllocation& allocation)
+	{
+		VkBuffer vertexBuffers[] = { m_Frames[m_Device->GetFrameIndex()].Blocks[allocation.Block].Buffer.Buffer };
+		VkDeviceSize offsets[] = { allocation.Offset };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	}
 
-		memcpy(mappedData, data, size);
+	VulkanRetainedVertexBuffer::VulkanRetainedVertexBuffer(Device* device, uint32_t size)
+		: m_Device((VulkanDevice*)device), m_Data(size, 0)
+	{
+		EC_CORE_ASSERT(size > 0, "Retained vertex buffer can't be empty!");
+	}
 
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+	VulkanRetainedVertexBuffer::~VulkanRetainedVertexBuffer()
+	{
+		for (FrameCopy& frame : m_Frames)
 		{
-			VkBufferCopy vertexCopy{ 0 };
-			vertexCopy.dstOffset = 0;
-			vertexCopy.srcOffset = 0;
-			vertexCopy.size = size;
+			if (frame.MappedData)
+				m_Device->RetireBuffer(frame.Buffer);
+		}
+	}
 
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &vertexCopy);
-		});
+	void VulkanRetainedVertexBuffer::Resize(uint32_t size)
+	{
+		if (size <= m_Data.size())
+			return;
 
-		m_Device->DestroyBuffer(staging);
+		// The frame buffers are replaced on their next Bind
+		m_Data.resize(size, 0);
 	}
 
-	void VulkanVertexBuffer::CreateBuffer(uint32_t size, bool isDynamic)
+	void VulkanRetainedVertexBuffer::Write(uint32_t offset, const void* data, uint32_t size)
 	{
-		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-										  isDynamic ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_TO_GPU);
+		EC_CORE_ASSERT(offset + size <= m_Data.size(), "Retained vertex buffer write out of bounds!");
+		memcpy(m_Data.data() + offset, data, size);
+
+		// Past this many separate ranges one copy of everything is cheaper
+		constexpr size_t MaxPendingRanges = 1024;
+		for (FrameCopy& frame : m_Frames)
+		{
+			if (frame.FullUpload)
+				continue;
+
+			if (!frame.Pending.empty() && offset <= frame.Pending.back().End && offset + size >= frame.Pending.back().Begin)
+			{
+				Range& last = frame.Pending.back();
+				last.Begin = std::min(last.Begin, offset);
+				last.End = std::max(last.End, offset + size);
+			}
+			else if (frame.Pending.size() < MaxPendingRanges)
+			{
+				frame.Pending.push_back({ offset, offset + size });
+			}
+			else
+			{
+				frame.Pending.clear();
+				frame.FullUpload = true;
+			}
+		}
+	}
+
+	void VulkanRetainedVertexBuffer::Bind(CommandBuffer* cmd)
+	{
+		EC_PROFILE_FUNCTION();
+		PrepareBind();
+		RecordBind(((VulkanCommandBuffer*)cmd)->GetCommandBuffer());
+	}
+
+	void VulkanRetainedVertexBuffer::PrepareBind()
+	{
+		FrameCopy& frame = m_Frames[m_Device->GetFrameIndex()];
+
+		EC_CORE_ASSERT(frame.BoundFrame != m_Device->GetFrameCount() || (frame.Pending.empty() && !frame.FullUpload && frame.Size >= m_Data.size()),
+			"Retained vertex buffer was written between two binds in one frame, the earlier draw would read the new data!");
+		frame.BoundFrame = m_Device->GetFrameCount();
+
+		if (frame.Size < m_Data.size())
+		{
+			if (frame.MappedData)
+				m_Device->RetireBuffer(frame.Buffer);
+
+			// CPU_TO_GPU prefers device local memory where the host can map it
+			frame.Size = (uint32_t)m_Data.size();
+			frame.Buffer = m_Device->CreateBuffer(frame.Size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU,
+												  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			frame.MappedData = (uint8_t*)m_Device->GetMappedData(frame.Buffer);
+			frame.FullUpload = true;
+		}
+
+		if (frame.FullUpload)
+		{
+			memcpy(frame.MappedData, m_Data.data(), m_Data.size());
+			frame.FullUpload = false;
+		}
+		else
+		{
+			for (const Range& range : frame.Pending)
+			{
+				memcpy(frame.MappedData + range.Begin, m_Data.data() + range.Begin, range.End - range.Begin);
+			}
+		}
+		frame.Pending.clear();
+	}
+
+	void VulkanRetainedVertexBuffer::RecordBind(VkCommandBuffer commandBuffer)
+	{
+		VkBuffer vertexBuffers[] = { m_Frames[m_Device->GetFrameIndex()].Buffer.Buffer };
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 	}
 
 	VulkanIndexBuffer::VulkanIndexBuffer(Device* device, std::vector<uint32_t> indices)
@@ -128,97 +281,37 @@ namespace Echo
 
 	VulkanIndexBuffer::~VulkanIndexBuffer()
 	{
-		m_Device->DestroyBuffer(m_Buffer);
+		m_Device->RetireBuffer(m_Buffer);
 	}
 
 	void VulkanIndexBuffer::Bind(CommandBuffer* cmd)
 	{
 		EC_PROFILE_FUNCTION();
-		VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)cmd)->GetCommandBuffer();
+		RecordBind(((VulkanCommandBuffer*)cmd)->GetCommandBuffer());
+	}
 
+	void VulkanIndexBuffer::RecordBind(VkCommandBuffer commandBuffer)
+	{
 		vkCmdBindIndexBuffer(commandBuffer, m_Buffer.Buffer, 0, VK_INDEX_TYPE_UINT32);
 	}
 
 	void VulkanIndexBuffer::SetIndices(std::vector<uint32_t> indices)
 	{
-		EC_PROFILE_FUNCTION();
-		const size_t bufferSize = indices.size() * sizeof(uint32_t);
-
-		// Check if we need to resize the buffer
-		VkMemoryRequirements memReqs;
-		vkGetBufferMemoryRequirements(m_Device->GetDevice(), m_Buffer.Buffer, &memReqs);
-
-		if (bufferSize > memReqs.size)
-		{
-			// Recreate buffer with new size
-			AllocatedBuffer oldBuffer = m_Buffer;
-
-			m_Buffer = m_Device->CreateBuffer(bufferSize,
-											  VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-											  VMA_MEMORY_USAGE_GPU_ONLY);
-
-			m_Device->DestroyBuffer(oldBuffer);
-		}
-
-		// Create staging buffer and upload data
-		AllocatedBuffer staging = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* mappedData = m_Device->GetMappedData(staging);
-
-		memcpy(mappedData, indices.data(), bufferSize);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy copy{};
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = bufferSize;
-
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(staging);
-		m_IndicesCount = indices.size();
+		SetIndices(indices.data(), (uint32_t)indices.size());
 	}
 
 	void VulkanIndexBuffer::SetIndices(uint32_t* indices, uint32_t count)
 	{
 		EC_PROFILE_FUNCTION();
-		const size_t bufferSize = count * sizeof(uint32_t);
-
-		// Check if we need to resize the buffer
-		VkMemoryRequirements memReqs;
-		vkGetBufferMemoryRequirements(m_Device->GetDevice(), m_Buffer.Buffer, &memReqs);
-
-		if (bufferSize > memReqs.size)
+		// Same as VulkanVertexBuffer::SetData, never upload over a buffer frames in flight may be reading
+		if (indices == nullptr || count == 0)
 		{
-			// Recreate buffer with new size
-			AllocatedBuffer oldBuffer = m_Buffer;
-
-			m_Buffer = m_Device->CreateBuffer(bufferSize,
-											  VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-											  VMA_MEMORY_USAGE_GPU_ONLY);
-
-			m_Device->DestroyBuffer(oldBuffer);
+			m_IndicesCount = 0;
+			return;
 		}
 
-		// Create staging buffer and upload data
-		AllocatedBuffer staging = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* mappedData = m_Device->GetMappedData(staging);
-
-		memcpy(mappedData, indices, bufferSize);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy copy{};
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = bufferSize;
-
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(staging);
-		m_IndicesCount = count;
+		m_Device->RetireBuffer(m_Buffer);
+		CreateBuffer(indices, count);
 	}
 
 	void VulkanIndexBuffer::CreateBuffer(std::vector<uint32_t> indices)
@@ -229,22 +322,7 @@ namespace Echo
 		m_Buffer = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
 										  VMA_MEMORY_USAGE_GPU_ONLY);
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* data = m_Device->GetMappedData(staging);
-
-		memcpy(data, indices.data(), bufferSize);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy indexCopy{ 0 };
-			indexCopy.dstOffset = 0;
-			indexCopy.srcOffset = 0;
-			indexCopy.size = bufferSize;
-
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &indexCopy);
-		});
-
-		m_Device->DestroyBuffer(staging);
+		m_Device->GetUploadManager()->UploadBuffer(m_Buffer.Buffer, 0, indices.data(), bufferSize);
 		m_IndicesCount = indices.size();
 	}
 
@@ -256,22 +334,7 @@ namespace Echo
 		m_Buffer = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
 										  VMA_MEMORY_USAGE_GPU_ONLY);
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* data = m_Device->GetMappedData(staging);
-
-		memcpy(data, indices, bufferSize);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy indexCopy{ 0 };
-			indexCopy.dstOffset = 0;
-			indexCopy.srcOffset = 0;
-			indexCopy.size = bufferSize;
-
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &indexCopy);
-		});
-
-		m_Device->DestroyBuffer(staging);
+		m_Device->GetUploadManager()->UploadBuffer(m_Buffer.Buffer, 0, indices, bufferSize);
 		m_IndicesCount = count;
 	}
 
@@ -283,7 +346,7 @@ namespace Echo
 
 	VulkanIndirectBuffer::~VulkanIndirectBuffer()
 	{
-		m_Device->DestroyBuffer(m_Buffer);
+		m_Device->RetireBuffer(m_Buffer);
 	}
 
 	void VulkanIndirectBuffer::AddToIndirectBuffer(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
@@ -308,7 +371,7 @@ namespace Echo
 		AllocatedBuffer oldBuffer = m_Buffer;
 		CreateBuffer();
 
-		m_Device->DestroyBuffer(oldBuffer);
+		m_Device->RetireBuffer(oldBuffer);
 	}
 
 	void VulkanIndirectBuffer::CreateBuffer()
@@ -322,21 +385,7 @@ namespace Echo
 		if (m_IndirectCommands.empty())
 			return; 
 
-		AllocatedBuffer stagingBuffer = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* data = m_Device->GetMappedData(stagingBuffer);
-
-		memcpy(data, m_IndirectCommands.data(), bufferSize);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy copy{ 0 };
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = bufferSize;
-			vkCmdCopyBuffer(cmd, stagingBuffer.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(stagingBuffer);
+		m_Device->GetUploadManager()->UploadBuffer(m_Buffer.Buffer, 0, m_IndirectCommands.data(), bufferSize);
 	}
 
 	void VulkanIndirectBuffer::UpdateIndirectBufferGPU()
@@ -344,81 +393,39 @@ namespace Echo
 		EC_PROFILE_FUNCTION();
 		uint32_t bufferSize = sizeof(VkDrawIndexedIndirectCommand) * m_IndirectCommands.size();
 
-		AllocatedBuffer stagingBuffer = m_Device->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* data = m_Device->GetMappedData(stagingBuffer);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd) 
-		{
-			memcpy(data, m_IndirectCommands.data(), bufferSize);
-			VkBufferCopy copy{ 0 };
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = bufferSize;
-			vkCmdCopyBuffer(cmd, stagingBuffer.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(stagingBuffer);
+		m_Device->GetUploadManager()->UploadBuffer(m_Buffer.Buffer, 0, m_IndirectCommands.data(), bufferSize);
 	}
 
 	VulkanUniformBuffer::VulkanUniformBuffer(Device* device, void* data, uint32_t size)
 		: m_Device((VulkanDevice*)device), m_Size(size)
 	{
-		CreateBuffer(data, size);
-	}
-
-	VulkanUniformBuffer::~VulkanUniformBuffer()
-	{
-		m_Device->DestroyBuffer(m_Buffer);
+		SetData(data, size);
 	}
 
 	void VulkanUniformBuffer::SetData(void* data, uint32_t size)
 	{
 		EC_PROFILE_FUNCTION();
 		m_Size = size;
-		AllocatedBuffer oldBuffer = m_Buffer;
-
-		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-										  VMA_MEMORY_USAGE_CPU_TO_GPU);
+		m_Data.assign((uint8_t*)data, (uint8_t*)data + size);
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* mappedData = m_Device->GetMappedData(staging);
-
-		memcpy(mappedData, data, size);
-
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy copy{};
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = size;
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(staging);
-		m_Device->DestroyBuffer(oldBuffer);
+		WriteToRing();
 	}
 
-	void VulkanUniformBuffer::CreateBuffer(void* data, uint32_t size)
+	uint32_t VulkanUniformBuffer::GetOffset()
 	{
-		EC_PROFILE_FUNCTION();
-		m_Buffer = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-										  VMA_MEMORY_USAGE_CPU_TO_GPU);
+		if (m_FrameCount != m_Device->GetFrameCount())
+			WriteToRing();
 
-		AllocatedBuffer staging = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-		void* mappedData = m_Device->GetMappedData(staging);
+		return m_Offset;
+	}
 
-		memcpy(mappedData, data, size);
+	void VulkanUniformBuffer::WriteToRing()
+	{
+		void* mappedData;
+		m_Offset = m_Device->GetUniformRing()->Allocate(m_Size, &mappedData);
+		memcpy(mappedData, m_Data.data(), m_Size);
 
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VkBufferCopy copy{};
-			copy.srcOffset = 0;
-			copy.dstOffset = 0;
-			copy.size = size;
-			vkCmdCopyBuffer(cmd, staging.Buffer, m_Buffer.Buffer, 1, &copy);
-		});
-
-		m_Device->DestroyBuffer(staging);
+		m_FrameCount = m_Device->GetFrameCount();
 	}
 
 }
\ No newline at end of file
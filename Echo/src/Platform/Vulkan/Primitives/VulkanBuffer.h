@@ -18,6 +18,7 @@ namespace Echo
 		virtual ~VulkanVertexBuffer();
 
 		virtual void Bind(CommandBuffer* cmd) override;
+		void RecordBind(VkCommandBuffer commandBuffer);
 		virtual void SetData(void* data, uint32_t size) override;
 		
 		virtual void* GetMappedData() override { return m_Device->GetMappedData(m_Buffer); };
@@ -28,6 +29,91 @@ namespace Echo
 		VulkanDevice* m_Device;
 
 		AllocatedBuffer m_Buffer;
+		bool m_IsDynamic;
+	};
+
+	// Each frame in flight owns a list of blocks it allocates from front to back. The frame's render
+	// fence is waited on before it records again, so resetting its cursor needs no other sync
+	class VulkanStreamingVertexBuffer : public StreamingVertexBuffer
+	{
+	public:
+		VulkanStreamingVertexBuffer(Device* device, uint32_t blockSize);
+		virtual ~VulkanStreamingVertexBuffer();
+
+		virtual StreamingAllocation Allocate(uint32_t size) override;
+		virtual void Trim(StreamingAllocation& allocation, uint32_t usedSize) override;
+
+		virtual void Bind(CommandBuffer* cmd, const StreamingAllocation& allocation) override;
+		void RecordBind(VkCommandBuffer commandBuffer, const StreamingAllocation& allocation);
+	private:
+		struct Block
+		{
+			AllocatedBuffer Buffer;
+			uint8_t* MappedData;
+			VkDeviceSize Size;
+		};
+
+		struct FrameBlocks
+		{
+			std::vector<Block> Blocks;
+			uint32_t CurrentBlock = 0;
+			VkDeviceSize Cursor = 0;
+
+			uint32_t FrameCount = UINT32_MAX;
+		};
+
+		FrameBlocks& GetCurrentFrame();
+	private:
+		VulkanDevice* m_Device;
+		VkDeviceSize m_BlockSize;
+
+		FrameBlocks m_Frames[Device::MAX_FRAMES_IN_FLIGHT];
+	};
+
+	// One coherent, persistently mapped buffer per frame in flight, each with its own list of ranges
+	// still to copy from the CPU copy. Bind runs after the frame's render fence was waited on, so the
+	// frame's buffer can be patched or replaced without other sync
+	class VulkanRetainedVertexBuffer : public RetainedVertexBuffer
+	{
+	public:
+		VulkanRetainedVertexBuffer(Device* device, uint32_t size);
+		virtual ~VulkanRetainedVertexBuffer();
+
+		virtual void Resize(uint32_t size) override;
+		virtual uint32_t GetSize() const override { return (uint32_t)m_Data.size(); }
+
+		virtual void Write(uint32_t offset, const void* data, uint32_t size) override;
+
+		virtual void Bind(CommandBuffer* cmd) override;
+		// Brings the frame's copy up to date, after that RecordBind only reads and can run on any thread.
+		// The copy is patched in place, so binding again in the same frame after a Write would change
+		// what an earlier draw of this frame reads. That is asserted against
+		void PrepareBind();
+		void RecordBind(VkCommandBuffer commandBuffer);
+	private:
+		struct Range
+		{
+			uint32_t Begin;
+			uint32_t End;
+		};
+
+		struct FrameCopy
+		{
+			AllocatedBuffer Buffer{};
+			uint8_t* MappedData = nullptr;
+			uint32_t Size = 0;
+
+			std::vector<Range> Pending;
+			// Set when patching range by range isn't worth it anymore
+			bool FullUpload = true;
+			// Device frame count of the last bind
+			uint32_t BoundFrame = UINT32_MAX;
+		};
+	private:
+		VulkanDevice* m_Device;
+
+		std::vector<uint8_t> m_Data;
+		FrameCopy m_Frames[Device::MAX_FRAMES_IN_FLIGHT];
 	};
 
 	class VulkanIndexBuffer : public IndexBuffer
@@ -38,6 +124,7 @@ namespace Echo
 		virtual ~VulkanIndexBuffer();
 
 		virtual void Bind(CommandBuffer* cmd) override;
+		void RecordBind(VkCommandBuffer commandBuffer);
 
 		virtual void SetIndices(std::vector<uint32_t> indices) override;
 		virtual void SetIndices(uint32_t* indices, uint32_t count) override;
@@ -73,23 +160,29 @@ namespace Echo
 		AllocatedBuffer m_Buffer;
 	};
 
+	// Lives in the device's uniform ring, SetData copies into a fresh block of the current frame
 	class VulkanUniformBuffer : public UniformBuffer
 	{
 	public:
 		VulkanUniformBuffer(Device* device, void* data, uint32_t size);
-		virtual ~VulkanUniformBuffer();
+		virtual ~VulkanUniformBuffer() = default;
 
 		virtual void SetData(void* data, uint32_t size) override;
 
-		AllocatedBuffer GetBuffer() { return m_Buffer; }
+		VkBuffer GetBuffer() { return m_Device->GetUniformRing()->GetBuffer(); }
 		uint32_t GetSize() { return m_Size; }
+		// Dynamic offset of the data in GetBuffer(), copied forward if it was written in an earlier frame
+		uint32_t GetOffset();
 	private:
-		void CreateBuffer(void* data, uint32_t size);
+		void WriteToRing();
 	private:
 		VulkanDevice* m_Device;
-		AllocatedBuffer m_Buffer;
+		// Kept to carry the data over to frames that don't set it again
+		std::vector<uint8_t> m_Data;
 
 		uint32_t m_Size;
+		uint32_t m_Offset = 0;
+		uint32_t m_FrameCount = UINT32_MAX;
 	};
 
 }
\ No newline at end of file
@@ -5,16 +5,65 @@
 #include "Vulkan/Utils/VulkanInitializers.h"
 #include "Vulkan/Utils/VulkanImages.h"
 #include "VulkanFramebuffer.h"
+#include "VulkanBuffer.h"
+#include "VulkanPipeline.h"
+
+#include "Graphics/Commands/CommandStream.h"
+#include "Vulkan/Commands/VulkanClearColorCommand.h"
+#include "Vulkan/Commands/VulkanRenderingCommand.h"
+#include "Vulkan/Commands/VulkanRenderImGuiCommand.h"
 
 #include "Core/Application.h"
+#include "Core/JobSystem.h"
 
 #include <backends/imgui_impl_vulkan.h>
 
 namespace Echo
 {
 
+	// Below this many commands per thread, beginning and executing secondary command buffers costs more than
+	// recording the commands inline
+	static constexpr uint32_t MinSecondaryCommands = 256;
+
+	// Everything binding does besides recording, done before recording so that it can be spread across threads
+	static void PrepareCommand(const CommandHeader& header)
+	{
+		switch (header.Type)
+		{
+			case CommandType::BindPipeline:
+				((VulkanPipeline*)CommandStream::Decode<BindPipelinePacket>(header).Resource)->PrepareBind();
+				break;
+			case CommandType::BindRetainedVertexBuffer:
+				((VulkanRetainedVertexBuffer*)CommandStream::Decode<BindRetainedVertexBufferPacket>(header).Resource)->PrepareBind();
+				break;
+			default:
+				break;
+		}
+	}
+
+	// Commands that touch nothing but the command buffer they are recorded into
+	static bool IsSecondaryCommand(CommandType type)
+	{
+		switch (type)
+		{
+			case CommandType::BindPipeline:
+			case CommandType::BindVertexBuffer:
+			case CommandType::BindStreamingVertexBuffer:
+			case CommandType::BindRetainedVertexBuffer:
+			case CommandType::BindIndicesBuffer:
+			case CommandType::Draw:
+			case CommandType::DrawIndexed:
+			case CommandType::DrawIndexedIndirect:
+			case CommandType::SetScissor:
+			case CommandType::SetLineWidth:
+				return true;
+			default:
+				return false;
+		}
+	}
+
 	VulkanCommandBuffer::VulkanCommandBuffer(Device* device)
-		: m_Device(static_cast<VulkanDevice*>(device)), m_FrameData(m_Device->GetFrameData())
+		: m_Device(static_cast<VulkanDevice*>(device))
 	{
 
 	}
@@ -27,33 +76,20 @@ namespace Echo
 	void VulkanCommandBuffer::Start()
 	{
 		EC_PROFILE_FUNCTION();
-		m_FrameData = m_Device->GetFrameData();
-
-		vkWaitForFences(m_Device->GetDevice(), 1, &m_FrameData.RenderFence, VK_TRUE, UINT64_MAX);
-		vkResetFences(m_Device->GetDevice(), 1, &m_FrameData.RenderFence);
+		FrameData& frame = m_Device->GetFrameData();
 
-		if (m_FrameData.IsFirstPass)
-		{
-			m_FrameData.ImageIndex = m_Device->GetSwapchain().AcquireNextImage(
-				m_FrameData.SwapchainSemaphore
-			);
-
-
-			if (m_FrameData.ImageIndex == -1)
-			{
-				m_Device->RecreateSwapchain(Application::Get().GetWindow().GetWidth(), Application::Get().GetWindow().GetHeight(), &m_Device->GetSwapchain());
-				return;
-			}
-		}
+		// Only the first pass of a frame waits, for the frame slot to come back from the GPU
+		if (frame.IsFirstPass && !m_Device->BeginFrame())
+			return;
 
-		m_ImageIndex = m_FrameData.ImageIndex;
+		m_ImageIndex = frame.ImageIndex;
 
-		vkResetCommandBuffer(m_FrameData.CommandBuffer, 0);
+		m_CommandBuffer = m_Device->AllocateFrameCommandBuffer();
 		VkCommandBufferBeginInfo beginInfo = VulkanInitializers::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-		vkBeginCommandBuffer(m_FrameData.CommandBuffer, &beginInfo);
+		vkBeginCommandBuffer(m_CommandBuffer, &beginInfo);
 
-		VulkanImages::TransitionImage(m_FrameData.CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex),
-									  m_FrameData.IsFirstPass ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		VulkanImages::TransitionImage(m_CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex),
+									  frame.IsFirstPass ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
 									  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
 
@@ -66,23 +102,23 @@ namespace Echo
 		{
 			if (m_DrawToSwapchain)
 			{
-				VulkanImages::TransitionImage(m_FrameData.CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+				VulkanImages::TransitionImage(m_CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 			}
 			else
 			{
-				m_Framebuffer->TransitionImageLayout(m_FrameData.CommandBuffer, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+				m_Framebuffer->TransitionImageLayout(m_CommandBuffer, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 				if (!m_Framebuffer->IsUsingSamples())
 				{
-					VulkanImages::TransitionImage(m_FrameData.CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-					VulkanImages::CopyImageToImage(m_FrameData.CommandBuffer, m_Framebuffer->GetImage(0).Image, m_Device->GetSwapchainImage(m_ImageIndex), { m_Framebuffer->GetImage(0).ImageExtent.width, m_Framebuffer->GetImage(0).ImageExtent.height }, { m_Device->GetSwapchain().GetExtent().width, m_Device->GetSwapchain().GetExtent().height });
-					m_Framebuffer->TransitionImageLayout(m_FrameData.CommandBuffer, 0, VK_IMAGE_LAYOUT_GENERAL);
-					VulkanImages::TransitionImage(m_FrameData.CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex),
+					VulkanImages::TransitionImage(m_CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+					VulkanImages::CopyImageToImage(m_CommandBuffer, m_Framebuffer->GetImage(0).Image, m_Device->GetSwapchainImage(m_ImageIndex), { m_Framebuffer->GetImage(0).ImageExtent.width, m_Framebuffer->GetImage(0).ImageExtent.height }, { m_Device->GetSwapchain().GetExtent().width, m_Device->GetSwapchain().GetExtent().height });
+					m_Framebuffer->TransitionImageLayout(m_CommandBuffer, 0, VK_IMAGE_LAYOUT_GENERAL);
+					VulkanImages::TransitionImage(m_CommandBuffer, m_Device->GetSwapchainImage(m_ImageIndex),
 												  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 												  VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 				}
 				else 
 				{
-					VulkanImages::TransitionImage(m_FrameData.CommandBuffer,
+					VulkanImages::TransitionImage(m_CommandBuffer,
 												  m_Device->GetSwapchainImage(m_ImageIndex),
 												  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
 												  VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
@@ -90,29 +126,240 @@ namespace Echo
 			}
 		}
 
-		vkEndCommandBuffer(m_FrameData.CommandBuffer);
+		vkEndCommandBuffer(m_CommandBuffer);
 	}
 
-	void VulkanCommandBuffer::Submit(bool isLastPass)
+	void VulkanCommandBuffer::Execute(const CommandStream& commands, bool parallel)
 	{
 		EC_PROFILE_FUNCTION();
-		VkCommandBufferSubmitInfo cmdInfo = VulkanInitializers::CommandBufferSubmitInfo(m_FrameData.CommandBuffer);
+		if (!parallel || JobSystem::GetThreadCount() < 2 || commands.GetCommandCount() < 2 * MinSecondaryCommands)
+		{
+			commands.ForEach([this](const CommandHeader& header)
+			{
+				PrepareCommand(header);
+				RecordCommand(m_CommandBuffer, header);
+			});
+			return;
+		}
 
-		if (!m_ShouldPresent || !isLastPass)
+		m_Headers.clear();
+		commands.ForEach([this](const CommandHeader& header)
+		{
+			PrepareCommand(header);
+			m_Headers.push_back(&header);
+		});
+
+		uint32_t count = (uint32_t)m_Headers.size();
+		uint32_t index = 0;
+		while (index < count)
 		{
-			VkSubmitInfo2 submitInfo = VulkanInitializers::SubmitInfo(&cmdInfo, nullptr, nullptr);
-			vkQueueSubmit2(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_FrameData.RenderFence);
-			vkWaitForFences(m_Device->GetDevice(), 1, &m_FrameData.RenderFence, VK_TRUE, UINT64_MAX);
+			if (m_Headers[index]->Type != CommandType::BeginRendering)
+			{
+				RecordCommand(m_CommandBuffer, *m_Headers[index++]);
+				continue;
+			}
+
+			uint32_t end = index + 1;
+			bool secondary = true;
+			while (end < count && m_Headers[end]->Type != CommandType::EndRendering)
+			{
+				secondary &= IsSecondaryCommand(m_Headers[end]->Type);
+				end++;
+			}
+
+			if (secondary && end - index - 1 >= 2 * MinSecondaryCommands)
+			{
+				ExecuteRenderingParallel(index, end);
+			}
+			else
+			{
+				for (uint32_t i = index; i <= end && i < count; i++)
+					RecordCommand(m_CommandBuffer, *m_Headers[i]);
+			}
+			index = end + 1;
+		}
+	}
 
-			m_FrameData.IsFirstPass = false;
+	void VulkanCommandBuffer::ExecuteRenderingParallel(uint32_t begin, uint32_t end)
+	{
+		EC_PROFILE_FUNCTION();
+		RenderingInheritance inheritance;
+		if (!VulkanBeginRenderingCommand::ExecuteSecondary(this, CommandStream::Decode<BeginRenderingPacket>(*m_Headers[begin]), inheritance))
 			return;
+
+		uint32_t first = begin + 1;
+		uint32_t commandCount = end - first;
+		uint32_t rangeCount = std::min(JobSystem::GetThreadCount(), commandCount / MinSecondaryCommands);
+		uint32_t rangeSize = (commandCount + rangeCount - 1) / rangeCount;
+
+		// Secondary command buffers start without anything bound, each range takes along the state the
+		// commands in front of it left
+		m_SecondaryRanges.clear();
+		SecondaryRange range;
+		for (uint32_t i = first; i < end; i++)
+		{
+			if ((i - first) % rangeSize == 0)
+			{
+				range.Begin = i;
+				range.End = std::min(i + rangeSize, end);
+				m_SecondaryRanges.push_back(range);
+			}
+
+			const CommandHeader* header = m_Headers[i];
+			switch (header->Type)
+			{
+				case CommandType::BindPipeline: range.Pipeline = header; break;
+				case CommandType::BindVertexBuffer:
+				case CommandType::BindStreamingVertexBuffer:
+				case CommandType::BindRetainedVertexBuffer: range.VertexBuffer = header; break;
+				case CommandType::BindIndicesBuffer: range.IndexBuffer = header; break;
+				case CommandType::SetScissor: range.Scissor = header; break;
+				case CommandType::SetLineWidth: range.LineWidth = header; break;
+				default: break;
+			}
+		}
+
+		m_SecondaryCommandBuffers.resize(m_SecondaryRanges.size());
+		JobSystem::ParallelFor((uint32_t)m_SecondaryRanges.size(), 1, [this, &inheritance](uint32_t rangeBegin, uint32_t rangeEnd)
+		{
+			for (uint32_t i = rangeBegin; i < rangeEnd; i++)
+			{
+				m_SecondaryCommandBuffers[i] = RecordSecondary(m_SecondaryRanges[i], inheritance);
+			}
+		});
+
+		vkCmdExecuteCommands(m_CommandBuffer, (uint32_t)m_SecondaryCommandBuffers.size(), m_SecondaryCommandBuffers.data());
+
+		if (end < m_Headers.size())
+			vkCmdEndRendering(m_CommandBuffer);
+	}
+
+	VkCommandBuffer VulkanCommandBuffer::RecordSecondary(const SecondaryRange& range, const RenderingInheritance& inheritance)
+	{
+		EC_PROFILE_FUNCTION();
+		VkCommandBuffer cmd = m_Device->AllocateSecondaryCommandBuffer();
+
+		VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+		renderingInfo.colorAttachmentCount = (uint32_t)inheritance.ColorFormats.size();
+		renderingInfo.pColorAttachmentFormats = inheritance.ColorFormats.data();
+		renderingInfo.depthAttachmentFormat = inheritance.DepthFormat;
+		renderingInfo.rasterizationSamples = inheritance.Samples;
+
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.pNext = &renderingInfo;
+
+		VkCommandBufferBeginInfo beginInfo = VulkanInitializers::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+		vkBeginCommandBuffer(cmd, &beginInfo);
+
+		VulkanBeginRenderingCommand::SetViewport(cmd, inheritance.Extent);
+		for (const CommandHeader* state : { range.Pipeline, range.VertexBuffer, range.IndexBuffer, range.Scissor, range.LineWidth })
+		{
+			if (state)
+				RecordCommand(cmd, *state);
+		}
+
+		for (uint32_t i = range.Begin; i < range.End; i++)
+		{
+			RecordCommand(cmd, *m_Headers[i]);
+		}
+
+		vkEndCommandBuffer(cmd);
+		return cmd;
+	}
+
+	void VulkanCommandBuffer::RecordCommand(VkCommandBuffer cmd, const CommandHeader& header)
+	{
+		switch (header.Type)
+		{
+			case CommandType::ClearColor:
+				VulkanClearColorCommand::Execute(this, CommandStream::Decode<ClearColorPacket>(header));
+				break;
+			case CommandType::Dispatch:
+			{
+				const DispatchPacket& packet = CommandStream::Decode<DispatchPacket>(header);
+				vkCmdDispatch(cmd, packet.X, packet.Y, packet.Z);
+				break;
+			}
+			case CommandType::BindPipeline:
+				((VulkanPipeline*)CommandStream::Decode<BindPipelinePacket>(header).Resource)->RecordBind(cmd);
+				break;
+			case CommandType::BindVertexBuffer:
+				((VulkanVertexBuffer*)CommandStream::Decode<BindVertexBufferPacket>(header).Resource)->RecordBind(cmd);
+				break;
+			case CommandType::BindStreamingVertexBuffer:
+			{
+				const BindStreamingVertexBufferPacket& packet = CommandStream::Decode<BindStreamingVertexBufferPacket>(header);
+				((VulkanStreamingVertexBuffer*)packet.Resource)->RecordBind(cmd, packet.Allocation);
+				break;
+			}
+			case CommandType::BindRetainedVertexBuffer:
+				((VulkanRetainedVertexBuffer*)CommandStream::Decode<BindRetainedVertexBufferPacket>(header).Resource)->RecordBind(cmd);
+				break;
+			case CommandType::BindIndicesBuffer:
+				((VulkanIndexBuffer*)CommandStream::Decode<BindIndicesBufferPacket>(header).Resource)->RecordBind(cmd);
+				break;
+			case CommandType::Draw:
+			{
+				const DrawPacket& packet = CommandStream::Decode<DrawPacket>(header);
+				vkCmdDraw(cmd, packet.VertexCount, packet.InstanceCount, packet.FirstVertex, packet.FirstInstance);
+				break;
+			}
+			case CommandType::DrawIndexed:
+			{
+				const DrawIndexedPacket& packet = CommandStream::Decode<DrawIndexedPacket>(header);
+				vkCmdDrawIndexed(cmd, packet.IndexCount, packet.InstanceCount, packet.FirstIndex, packet.VertexOffset, packet.FirstInstance);
+				break;
+			}
+			case CommandType::DrawIndexedIndirect:
+			{
+				const DrawIndexedIndirectPacket& packet = CommandStream::Decode<DrawIndexedIndirectPacket>(header);
+				VkBuffer buffer = ((VulkanIndirectBuffer*)packet.Resource)->GetBuffer().Buffer;
+				vkCmdDrawIndexedIndirect(cmd, buffer, packet.Offset, packet.DrawCount, packet.Stride);
+				break;
+			}
+			case CommandType::SetScissor:
+			{
+				const SetScissorPacket& packet = CommandStream::Decode<SetScissorPacket>(header);
+				VkRect2D scissor{};
+				scissor.offset = { (int32_t)packet.X, (int32_t)packet.Y };
+				scissor.extent = { packet.Width, packet.Height };
+				vkCmdSetScissor(cmd, 0, 1, &scissor);
+				break;
+			}
+			case CommandType::SetLineWidth:
+				vkCmdSetLineWidth(cmd, CommandStream::Decode<SetLineWidthPacket>(header).LineWidth);
+				break;
+			case CommandType::BeginRendering:
+				VulkanBeginRenderingCommand::Execute(this, CommandStream::Decode<BeginRenderingPacket>(header));
+				break;
+			case CommandType::EndRendering:
+				vkCmdEndRendering(cmd);
+				break;
+			case CommandType::RenderImGui:
+				VulkanRenderImGuiCommand::Execute(this);
+				break;
+			default:
+				EC_CORE_ASSERT(false, "Unknown command type!");
+				break;
 		}
+	}
+
+	void VulkanCommandBuffer::Submit(bool isLastPass)
+	{
+		EC_PROFILE_FUNCTION();
+		FrameData& frame = m_Device->GetFrameData();
 
-		VkSemaphoreSubmitInfo signalSemaphoreInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, m_FrameData.RenderSemaphore);
-		VkSemaphoreSubmitInfo waitSemaphoreInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, m_FrameData.SwapchainSemaphore);
+		if (!m_ShouldPresent || !isLastPass)
+		{
+			m_Device->SubmitFrameCommandBuffer(m_CommandBuffer, false);
+			return;
+		}
 
-		VkSubmitInfo2 submitInfo = VulkanInitializers::SubmitInfo(&cmdInfo, &signalSemaphoreInfo, &waitSemaphoreInfo);
-		vkQueueSubmit2(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_FrameData.RenderFence);
+		VkSemaphore renderSemaphore = frame.RenderSemaphore;
+		m_Device->SubmitFrameCommandBuffer(m_CommandBuffer, true);
 
 		VkPresentInfoKHR presentInfo{};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -121,7 +368,6 @@ namespace Echo
 		presentInfo.pSwapchains = &swapchain;
 		presentInfo.swapchainCount = 1;
 
-		VkSemaphore renderSemaphore = m_FrameData.RenderSemaphore;
 		presentInfo.pWaitSemaphores = &renderSemaphore;
 		presentInfo.waitSemaphoreCount = 1;
 
@@ -139,7 +385,6 @@ namespace Echo
 		}
 
 		m_Device->AddFrame();
-		m_FrameData.IsFirstPass = true;
 	}
 
 
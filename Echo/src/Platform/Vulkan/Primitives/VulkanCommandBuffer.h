@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/Primitives/CommandBuffer.h"
+#include "Graphics/Commands/CommandStream.h"
 #include "VulkanDevice.h"
 
 #include "Graphics/Primitives/Framebuffer.h"
@@ -8,6 +9,8 @@
 namespace Echo 
 {
 
+	struct RenderingInheritance;
+
 	class VulkanCommandBuffer : public CommandBuffer
 	{
 	public:
@@ -18,6 +21,10 @@ namespace Echo
 		virtual void End() override;
 		virtual void Submit(bool isLastPass) override;
 
+		// With parallel set, renderings with enough commands are split across the job system into secondary
+		// command buffers that the primary executes in order
+		virtual void Execute(const CommandStream& commands, bool parallel) override;
+
 		virtual void SetSourceFramebuffer(Ref<Framebuffer> framebuffer) override;
 		virtual void SetDrawToSwapchain(bool drawToSwapchain) override { m_DrawToSwapchain = drawToSwapchain; };
 		virtual void SetShouldPresent(bool shouldPresent) override { m_ShouldPresent = shouldPresent; };
@@ -25,14 +32,35 @@ namespace Echo
 		bool DrawToSwapchain() { return m_DrawToSwapchain; }
 		uint32_t GetImageIndex() { return m_ImageIndex; }
 
-		VkCommandBuffer GetCommandBuffer() { return m_FrameData.CommandBuffer; }
+		VkCommandBuffer GetCommandBuffer() { return m_CommandBuffer; }
+	private:
+		// Commands that only bind, set state or draw, and whose state the previous ranges left bound
+		struct SecondaryRange
+		{
+			uint32_t Begin, End;
+
+			const CommandHeader* Pipeline = nullptr;
+			const CommandHeader* VertexBuffer = nullptr;
+			const CommandHeader* IndexBuffer = nullptr;
+			const CommandHeader* Scissor = nullptr;
+			const CommandHeader* LineWidth = nullptr;
+		};
+
+		void RecordCommand(VkCommandBuffer cmd, const CommandHeader& header);
+		// m_Headers[begin] is the BeginRendering, m_Headers[end] the EndRendering if there is one
+		void ExecuteRenderingParallel(uint32_t begin, uint32_t end);
+		VkCommandBuffer RecordSecondary(const SecondaryRange& range, const RenderingInheritance& inheritance);
 	private:
 		VulkanDevice* m_Device;
 
 		uint32_t m_ImageIndex;
 		VulkanFramebuffer* m_Framebuffer;
 
-		FrameData& m_FrameData;
+		VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+
+		std::vector<const CommandHeader*> m_Headers;
+		std::vector<SecondaryRange> m_SecondaryRanges;
+		std::vector<VkCommandBuffer> m_SecondaryCommandBuffers;
 
 		bool m_ShouldPresent = true;
 		bool m_DrawToSwapchain = false;		
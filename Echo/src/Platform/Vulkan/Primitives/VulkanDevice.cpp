@@ -4,6 +4,7 @@
 
 #include "Vulkan/Utils/VulkanInitializers.h"
 #include "Vulkan/Utils/VulkanImages.h"
+#include "Vulkan/Utils/VulkanTextureTable.h"
 
 #include "VkBootstrap.h"
 #include "Vulkan/VulkanSwapchain.h"
@@ -15,6 +16,8 @@
 
 #include "VulkanFramebuffer.h"
 
+#include "Core/JobSystem.h"
+
 #include <glm/glm.hpp>
 #include <array>
 
@@ -29,9 +32,12 @@ namespace Echo
 		VulkanRenderCaps::Init(this);
 
 		InitCommands();
+		m_UploadManager = CreateScope<VulkanUploadManager>(this, m_TransferQueue, m_TransferQueueFamily);
+		m_UniformRing = CreateScope<VulkanUniformRing>(this);
 		InitSyncStructures();
 		InitSwapchain();
 		CreateImGuiDescriptorPool();
+		m_TextureTable = CreateScope<VulkanTextureTable>(this, VulkanRenderCaps::GetMaxBindlessTextures());
 		
 		m_ShaderLibrary = ShaderLibrary(m_Device);
 	}
@@ -44,6 +50,8 @@ namespace Echo
 		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		{
 			vkDestroyCommandPool(m_Device, m_Frames[i].CommandPool, nullptr);
+			for (ThreadCommandPool& threadPool : m_Frames[i].ThreadPools)
+				vkDestroyCommandPool(m_Device, threadPool.CommandPool, nullptr);
 
 			vkDestroySemaphore(m_Device, m_Frames[i].SwapchainSemaphore, nullptr);
 			vkDestroySemaphore(m_Device, m_Frames[i].RenderSemaphore, nullptr);
@@ -53,6 +61,15 @@ namespace Echo
 		vkDestroyCommandPool(m_Device, m_ImmCommandPool, nullptr);
 		vkDestroyFence(m_Device, m_ImmFence, nullptr);
 		vkDestroyDescriptorPool(m_Device, m_ImGuiDescriptorPool, nullptr);
+		m_TextureTable.reset();
+		m_UploadManager.reset();
+		m_UniformRing.reset();
+
+		// Last, the members above may retire resources of their own
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			FlushRetired(m_Frames[i], true);
+		}
 
 		vmaDestroyAllocator(m_Allocator);
 		m_Swapchain->DestroySwapchain();
@@ -77,7 +94,7 @@ namespace Echo
 		return m_Swapchain->GetImageView(imageIndex);
 	}
 
-	AllocatedBuffer VulkanDevice::CreateBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage)
+	AllocatedBuffer VulkanDevice::CreateBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags requiredFlags)
 	{
 		
 		VkBufferCreateInfo bufferInfo = { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
@@ -89,6 +106,7 @@ namespace Echo
 		VmaAllocationCreateInfo vmaallocInfo = {};
 		vmaallocInfo.usage = memoryUsage;
 		vmaallocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+		vmaallocInfo.requiredFlags = requiredFlags;
 		AllocatedBuffer newBuffer;
 
 		vmaCreateBuffer(m_Allocator, &bufferInfo, &vmaallocInfo, &newBuffer.Buffer, &newBuffer.Allocation, &newBuffer.Info);
@@ -190,39 +208,16 @@ namespace Echo
 		return newImage;
 	}
 
-	AllocatedImage VulkanDevice::CreateImageTex(void* data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped /*= false*/)
+	AllocatedImage VulkanDevice::CreateImageTex(void* data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped /*= false*/, UploadToken* token /*= nullptr*/)
 	{
 		EC_PROFILE_FUNCTION();
 		size_t data_size = size.depth * size.width * size.height * 4;
-		AllocatedBuffer uploadbuffer = CreateBuffer(data_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-
-		memcpy(uploadbuffer.Info.pMappedData, data, data_size);
 
 		AllocatedImage newImage = CreateImageNoMSAA(size, format, usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
 
-		ImmediateSubmit([&](VkCommandBuffer cmd)
-		{
-			VulkanImages::TransitionImage(cmd, newImage.Image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-			VkBufferImageCopy copyRegion = {};
-			copyRegion.bufferOffset = 0;
-			copyRegion.bufferRowLength = 0;
-			copyRegion.bufferImageHeight = 0;
-
-			copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			copyRegion.imageSubresource.mipLevel = 0;
-			copyRegion.imageSubresource.baseArrayLayer = 0;
-			copyRegion.imageSubresource.layerCount = 1;
-			copyRegion.imageExtent = size;
-
-			vkCmdCopyBufferToImage(cmd, uploadbuffer.Buffer, newImage.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-								   &copyRegion);
-
-			VulkanImages::TransitionImage(cmd, newImage.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-									 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-		});
-
-		DestroyBuffer(uploadbuffer);
+		UploadToken upload = m_UploadManager->UploadImage(newImage.Image, size, data, data_size, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		if (token)
+			*token = upload;
 
 		return newImage;
 	}
@@ -234,6 +229,45 @@ namespace Echo
 		vmaDestroyImage(m_Allocator, image.Image, image.Allocation);
 	}
 
+	void VulkanDevice::RetireBuffer(const AllocatedBuffer& buffer)
+	{
+		std::lock_guard<std::mutex> lock(m_RetireMutex);
+		GetFrameData().RetiredBuffers.emplace_back(buffer, m_CurrentFrame);
+	}
+
+	void VulkanDevice::RetireImage(const AllocatedImage& image)
+	{
+		std::lock_guard<std::mutex> lock(m_RetireMutex);
+		GetFrameData().RetiredImages.emplace_back(image, m_CurrentFrame);
+	}
+
+	void VulkanDevice::RetireSampler(VkSampler sampler)
+	{
+		std::lock_guard<std::mutex> lock(m_RetireMutex);
+		GetFrameData().RetiredSamplers.emplace_back(sampler, m_CurrentFrame);
+	}
+
+	void VulkanDevice::FlushRetired(FrameData& frame, bool all)
+	{
+		EC_PROFILE_FUNCTION();
+		// Retired before this frame means the slot's last frame at the latest, which the fence wait covered.
+		// Retired in it (between AddFrame and BeginFrame) the previous frame may still be in flight
+		auto flush = [this, all](auto& retired, auto&& destroy)
+		{
+			auto expired = all ? retired.begin() : std::partition(retired.begin(), retired.end(), [this](const auto& entry) { return entry.second == m_CurrentFrame; });
+			for (auto it = expired; it != retired.end(); it++)
+			{
+				destroy(it->first);
+			}
+			retired.erase(expired, retired.end());
+		};
+
+		std::lock_guard<std::mutex> lock(m_RetireMutex);
+		flush(frame.RetiredBuffers, [this](const AllocatedBuffer& buffer) { DestroyBuffer(buffer); });
+		flush(frame.RetiredImages, [this](const AllocatedImage& image) { DestroyImage(image); });
+		flush(frame.RetiredSamplers, [this](VkSampler sampler) { vkDestroySampler(m_Device, sampler, nullptr); });
+	}
+
 	void VulkanDevice::ImmediateSubmit(std::function<void(VkCommandBuffer cmd)>&& function)
 	{
 		EC_PROFILE_FUNCTION();
@@ -246,17 +280,159 @@ namespace Echo
 
 		vkBeginCommandBuffer(cmd, &cmdBeginInfo);
 
+		if (m_UploadManager->HasPendingAcquires())
+			m_UploadManager->RecordAcquires(cmd);
+
 		function(cmd);
 
 		vkEndCommandBuffer(cmd);
 
-		VkCommandBufferSubmitInfo cmdinfo = VulkanInitializers::CommandBufferSubmitInfo(cmd);
-		VkSubmitInfo2 submit = VulkanInitializers::SubmitInfo(&cmdinfo, nullptr, nullptr);
-
-		vkQueueSubmit2(m_GraphicsQueue, 1, &submit, m_ImmFence);
+		SubmitGraphics(&cmd, 1, nullptr, nullptr, m_ImmFence);
 		vkWaitForFences(m_Device, 1, &m_ImmFence, true, UINT64_MAX);
 	}
 
+	void VulkanDevice::FrameSubmit(std::function<void(VkCommandBuffer cmd)>&& function)
+	{
+		EC_PROFILE_FUNCTION();
+		if (GetFrameData().IsFirstPass)
+		{
+			ImmediateSubmit(std::move(function));
+			return;
+		}
+
+		VkCommandBuffer cmd = AllocateFrameCommandBuffer();
+
+		VkCommandBufferBeginInfo cmdBeginInfo = VulkanInitializers::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		vkBeginCommandBuffer(cmd, &cmdBeginInfo);
+
+		function(cmd);
+
+		vkEndCommandBuffer(cmd);
+
+		SubmitFrameCommandBuffer(cmd, false);
+	}
+
+	bool VulkanDevice::BeginFrame()
+	{
+		EC_PROFILE_FUNCTION();
+		FrameData& frame = GetFrameData();
+
+		{
+			EC_PROFILE_SCOPE("Wait For Frame In Flight");
+			vkWaitForFences(m_Device, 1, &frame.RenderFence, VK_TRUE, UINT64_MAX);
+		}
+		FlushRetired(frame, false);
+
+		vkResetCommandPool(m_Device, frame.CommandPool, 0);
+		frame.UsedCommandBuffers = 0;
+		for (ThreadCommandPool& threadPool : frame.ThreadPools)
+		{
+			if (threadPool.UsedCommandBuffers == 0)
+				continue;
+
+			vkResetCommandPool(m_Device, threadPool.CommandPool, 0);
+			threadPool.UsedCommandBuffers = 0;
+		}
+
+		frame.ImageIndex = m_Swapchain->AcquireNextImage(frame.SwapchainSemaphore);
+		if (frame.ImageIndex == -1)
+		{
+			RecreateSwapchain(m_Window->GetWidth(), m_Window->GetHeight(), m_Swapchain.get());
+			return false;
+		}
+
+		return true;
+	}
+
+	VkCommandBuffer VulkanDevice::AllocateFrameCommandBuffer()
+	{
+		FrameData& frame = GetFrameData();
+		if (frame.UsedCommandBuffers == frame.CommandBuffers.size())
+		{
+			VkCommandBuffer cmd;
+			VkCommandBufferAllocateInfo cmdAllocInfo = VulkanInitializers::CommandBufferAllocateInfo(frame.CommandPool, 1);
+			vkAllocateCommandBuffers(m_Device, &cmdAllocInfo, &cmd);
+			frame.CommandBuffers.push_back(cmd);
+		}
+
+		return frame.CommandBuffers[frame.UsedCommandBuffers++];
+	}
+
+	VkCommandBuffer VulkanDevice::AllocateSecondaryCommandBuffer()
+	{
+		uint32_t threadIndex = JobSystem::GetThreadIndex();
+		FrameData& frame = GetFrameData();
+		EC_CORE_ASSERT(threadIndex < frame.ThreadPools.size(), "Secondary command buffers can only be recorded on job system threads!");
+
+		ThreadCommandPool& threadPool = frame.ThreadPools[threadIndex];
+		if (threadPool.UsedCommandBuffers == threadPool.CommandBuffers.size())
+		{
+			VkCommandBuffer cmd;
+			VkCommandBufferAllocateInfo cmdAllocInfo = VulkanInitializers::CommandBufferAllocateInfo(threadPool.CommandPool, 1);
+			cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			vkAllocateCommandBuffers(m_Device, &cmdAllocInfo, &cmd);
+			threadPool.CommandBuffers.push_back(cmd);
+		}
+
+		return threadPool.CommandBuffers[threadPool.UsedCommandBuffers++];
+	}
+
+	void VulkanDevice::SubmitFrameCommandBuffer(VkCommandBuffer cmd, bool endFrame)
+	{
+		EC_PROFILE_FUNCTION();
+		FrameData& frame = GetFrameData();
+
+		// The swapchain image barriers use every stage, so the wait has to cover them all
+		VkSemaphoreSubmitInfo waitSemaphoreInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, frame.SwapchainSemaphore);
+		VkSemaphoreSubmitInfo signalSemaphoreInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, frame.RenderSemaphore);
+
+		VkFence fence = VK_NULL_HANDLE;
+		if (endFrame)
+		{
+			vkResetFences(m_Device, 1, &frame.RenderFence);
+			fence = frame.RenderFence;
+		}
+
+		// Resources uploaded while the pass was recorded are taken over by the graphics queue ahead of it
+		VkCommandBuffer cmds[2];
+		uint32_t cmdCount = 0;
+		if (m_UploadManager->HasPendingAcquires())
+		{
+			VkCommandBuffer acquireCmd = AllocateFrameCommandBuffer();
+			VkCommandBufferBeginInfo cmdBeginInfo = VulkanInitializers::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+			vkBeginCommandBuffer(acquireCmd, &cmdBeginInfo);
+			m_UploadManager->RecordAcquires(acquireCmd);
+			vkEndCommandBuffer(acquireCmd);
+
+			cmds[cmdCount++] = acquireCmd;
+		}
+		cmds[cmdCount++] = cmd;
+
+		SubmitGraphics(cmds, cmdCount, frame.IsFirstPass ? &waitSemaphoreInfo : nullptr, endFrame ? &signalSemaphoreInfo : nullptr, fence);
+		frame.IsFirstPass = endFrame;
+	}
+
+	void VulkanDevice::SubmitGraphics(VkCommandBuffer* cmds, uint32_t cmdCount, VkSemaphoreSubmitInfo* waitSemaphoreInfo, VkSemaphoreSubmitInfo* signalSemaphoreInfo, VkFence fence)
+	{
+		EC_CORE_ASSERT(cmdCount <= 2, "Too many command buffers for one graphics submission!");
+		VkCommandBufferSubmitInfo cmdInfos[2];
+		for (uint32_t i = 0; i < cmdCount; i++)
+			cmdInfos[i] = VulkanInitializers::CommandBufferSubmitInfo(cmds[i]);
+
+		VkSemaphoreSubmitInfo waitInfos[2];
+		uint32_t waitCount = 0;
+		if (waitSemaphoreInfo)
+			waitInfos[waitCount++] = *waitSemaphoreInfo;
+		if (m_UploadManager->PrepareGraphicsSubmit(waitInfos[waitCount]))
+			waitCount++;
+
+		VkSubmitInfo2 submitInfo = VulkanInitializers::SubmitInfo(cmdInfos, signalSemaphoreInfo, waitCount > 0 ? waitInfos : nullptr);
+		submitInfo.commandBufferInfoCount = cmdCount;
+		submitInfo.waitSemaphoreInfoCount = waitCount;
+
+		vkQueueSubmit2(m_GraphicsQueue, 1, &submitInfo, fence);
+	}
+
 	void* VulkanDevice::GetMappedData(const AllocatedBuffer& buffer)
 	{
 		return buffer.Allocation->GetMappedData();
@@ -288,6 +464,13 @@ namespace Echo
 		features12.bufferDeviceAddress = true;
 		features12.descriptorIndexing = true;
 		features12.runtimeDescriptorArray = true;
+		// Texture table
+		features12.descriptorBindingPartiallyBound = true;
+		features12.descriptorBindingSampledImageUpdateAfterBind = true;
+		features12.descriptorBindingUpdateUnusedWhilePending = true;
+		features12.shaderSampledImageArrayNonUniformIndexing = true;
+		// Upload manager
+		features12.timelineSemaphore = true;
 
 		VkPhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.shaderStorageImageMultisample = true;
@@ -319,6 +502,18 @@ namespace Echo
 		m_PresentQueue = vkbDevice.get_queue(vkb::QueueType::present).value();
 		m_PresentQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::present).value();
 
+		auto transferQueue = vkbDevice.get_dedicated_queue(vkb::QueueType::transfer);
+		if (transferQueue.has_value())
+		{
+			m_TransferQueue = transferQueue.value();
+			m_TransferQueueFamily = vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+		}
+		else
+		{
+			m_TransferQueue = m_GraphicsQueue;
+			m_TransferQueueFamily = m_GraphicsQueueFamily;
+		}
+
 		VmaAllocatorCreateInfo allocatorInfo = {};
 		allocatorInfo.physicalDevice = m_PhysicalDevice;
 		allocatorInfo.device = m_Device;
@@ -383,8 +578,10 @@ namespace Echo
 		{
 			vkCreateCommandPool(m_Device, &poolCreateInfo, nullptr, &m_Frames[i].CommandPool);
 
-			VkCommandBufferAllocateInfo cmdAllocInfo = VulkanInitializers::CommandBufferAllocateInfo(m_Frames[i].CommandPool, 1);
-			vkAllocateCommandBuffers(m_Device, &cmdAllocInfo, &m_Frames[i].CommandBuffer);
+			// The job system is up before the window creates the device, its thread count is final
+			m_Frames[i].ThreadPools.resize(JobSystem::GetThreadCount());
+			for (ThreadCommandPool& threadPool : m_Frames[i].ThreadPools)
+				vkCreateCommandPool(m_Device, &poolCreateInfo, nullptr, &threadPool.CommandPool);
 		}
 
 		vkCreateCommandPool(m_Device, &poolCreateInfo, nullptr, &m_ImmCommandPool);
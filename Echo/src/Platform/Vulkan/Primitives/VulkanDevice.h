@@ -6,27 +6,54 @@
 
 #include "vk_mem_alloc.h"
 #include "Vulkan/Utils/VulkanTypes.h"
+#include "Vulkan/Utils/VulkanUploadManager.h"
+#include "Vulkan/Utils/VulkanUniformRing.h"
 #include "Vulkan/Shader/ShaderCompiler.h"
 #include "Windows/WindowsWindow.h"
 
+#include <mutex>
+
 namespace Echo
 {
 
+	// Command buffers one job system thread records in parallel with the others. Vulkan wants a pool
+	// to only ever be used by one thread at a time, so each thread gets its own
+	struct ThreadCommandPool
+	{
+		VkCommandPool CommandPool = VK_NULL_HANDLE;
+		std::vector<VkCommandBuffer> CommandBuffers;
+		uint32_t UsedCommandBuffers = 0;
+	};
+
 	struct FrameData
 	{
 		VkSemaphore SwapchainSemaphore, RenderSemaphore;
+		// Signalled by the frame's last submission, the only fence the CPU waits on while rendering
 		VkFence RenderFence;
 
+		// Every pass of the frame records into a command buffer of its own. The pool is reset as a whole
+		// once RenderFence says the GPU is done with the frame
 		VkCommandPool CommandPool;
-		VkCommandBuffer CommandBuffer;
+		std::vector<VkCommandBuffer> CommandBuffers;
+		uint32_t UsedCommandBuffers = 0;
+		// Secondary command buffers, indexed by JobSystem::GetThreadIndex(). Reset together with CommandPool
+		std::vector<ThreadCommandPool> ThreadPools;
+
+		// Resources released while earlier frames could still be using them, with the frame count they were
+		// retired in. Destroyed by the slot's next BeginFrame after the fence wait, unless retired in that frame
+		std::vector<std::pair<AllocatedBuffer, uint32_t>> RetiredBuffers;
+		std::vector<std::pair<AllocatedImage, uint32_t>> RetiredImages;
+		std::vector<std::pair<VkSampler, uint32_t>> RetiredSamplers;
 
 		uint32_t ImageIndex;
+		// Nothing of the frame has been submitted yet, the first submission waits for the swapchain image
 		bool IsFirstPass = true;
 	};
 
 	class VulkanSwapchain;
 	class VulkanFramebuffer;
 	class VulkanTexture2D;
+	class VulkanTextureTable;
 
 	class VulkanDevice : public Device
 	{
@@ -37,13 +64,16 @@ namespace Echo
 		virtual const DeviceType GetDeviceType() const override { return DeviceType::Vulkan; };
 		virtual const uint32_t GetMaxTextureSlots() const override;
 
-		FrameData& GetFrameData() { return m_Frames[m_CurrentFrame % MAX_FRAMES_IN_FLIGHT]; }
+		FrameData& GetFrameData() { return m_Frames[GetFrameIndex()]; }
+		uint32_t GetFrameIndex() { return m_CurrentFrame % MAX_FRAMES_IN_FLIGHT; }
+		uint32_t GetFrameCount() { return m_CurrentFrame; }
 
 		ShaderLibrary GetShaderLibrary() { return m_ShaderLibrary; }
 
 		VkInstance GetInstance() { return m_Instance; }
 		VkQueue GetGraphicsQueue() { return m_GraphicsQueue; }
 		VkQueue GetPresentQueue() { return m_PresentQueue; }
+		VkQueue GetTransferQueue() { return m_TransferQueue; }
 		VkDevice GetDevice() { return m_Device; }
 		VkPhysicalDevice GetPhysicalDevice() { return m_PhysicalDevice; }
 		VkSurfaceKHR GetSurface() { return m_Surface; }
@@ -52,6 +82,7 @@ namespace Echo
 		
 		uint32_t GetGraphicsQueueFamily() { return m_GraphicsQueueFamily; }
 		uint32_t GetPresentQueueFamily() { return m_PresentQueueFamily; }
+		uint32_t GetTransferQueueFamily() { return m_TransferQueueFamily; }
 
 		VulkanSwapchain& GetSwapchain() { return *m_Swapchain; }
 
@@ -62,15 +93,35 @@ namespace Echo
 		VkImage GetSwapchainImage(uint32_t imageIndex);
 		VkImageView GetSwapchainImageView(uint32_t imageIndex);
 
-		AllocatedBuffer CreateBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage);
+		AllocatedBuffer CreateBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags requiredFlags = 0);
 		void DestroyBuffer(const AllocatedBuffer& buffer);
 
 		AllocatedImage CreateImage(VkExtent3D size, VkFormat format, VkImageUsageFlags usage);
 		AllocatedImage CreateImageNoMSAA(VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false);
-		AllocatedImage CreateImageTex(void* data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false);
+		// The pixels are uploaded asynchronously, token (if given) tells when the image holds them
+		AllocatedImage CreateImageTex(void* data, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false, UploadToken* token = nullptr);
 		void DestroyImage(const AllocatedImage& image);
 
+		// Destroy the buffer, image or sampler once no frame in flight can be using it anymore. Every resource
+		// a frame may have recorded goes through these, replaced or destroyed. Safe from any thread
+		void RetireBuffer(const AllocatedBuffer& buffer);
+		void RetireImage(const AllocatedImage& image);
+		void RetireSampler(VkSampler sampler);
+
 		void ImmediateSubmit(std::function<void(VkCommandBuffer cmd)>&& function);
+		// Records into a command buffer of the current frame and submits it behind the passes already
+		// submitted, without waiting for the GPU. Goes through ImmediateSubmit outside of a frame
+		void FrameSubmit(std::function<void(VkCommandBuffer cmd)>&& function);
+
+		// Waits until the GPU is done with the frame slot's last use and acquires the swapchain image.
+		// Returns false if the swapchain had to be recreated instead
+		bool BeginFrame();
+		VkCommandBuffer AllocateFrameCommandBuffer();
+		// May be called from any job system thread, each allocates from the frame's pool of its thread
+		VkCommandBuffer AllocateSecondaryCommandBuffer();
+		// Passes are ordered by the queue and the barriers they record, only the frame's last submission
+		// signals RenderFence and RenderSemaphore
+		void SubmitFrameCommandBuffer(VkCommandBuffer cmd, bool endFrame);
 
 		void* GetMappedData(const AllocatedBuffer& buffer);
 		
@@ -84,12 +135,22 @@ namespace Echo
 		std::vector<VulkanTexture2D*> GetImGuiTextures() { return m_ImGuiTextures; }
 
 		void AddFrame() { m_CurrentFrame++; }
+
+		VulkanTextureTable* GetTextureTable() { return m_TextureTable.get(); }
+		VulkanUploadManager* GetUploadManager() { return m_UploadManager.get(); }
+		VulkanUniformRing* GetUniformRing() { return m_UniformRing.get(); }
 	private:
 		void InitVulkan();
 		void InitSwapchain();
 		void InitSyncStructures();
 		void InitCommands();
 		void CreateImGuiDescriptorPool();
+
+		// Destroys what the frame slot retired before the current frame, or everything once the device is idle
+		void FlushRetired(FrameData& frame, bool all);
+
+		// Flushes pending uploads and adds the wait on them, every graphics submission goes through here
+		void SubmitGraphics(VkCommandBuffer* cmds, uint32_t cmdCount, VkSemaphoreSubmitInfo* waitSemaphoreInfo, VkSemaphoreSubmitInfo* signalSemaphoreInfo, VkFence fence);
 	private:
 		Window* m_Window;
 		HWND m_WindowHandle;
@@ -103,6 +164,9 @@ namespace Echo
 		uint32_t m_GraphicsQueueFamily;
 		VkQueue m_PresentQueue;
 		uint32_t m_PresentQueueFamily;
+		// A dedicated transfer queue when the device has one, the graphics queue otherwise
+		VkQueue m_TransferQueue;
+		uint32_t m_TransferQueueFamily;
 		VkSurfaceKHR m_Surface;
 		VkDebugUtilsMessengerEXT m_DebugMessenger;
 
@@ -111,6 +175,9 @@ namespace Echo
 		VkCommandPool m_ImmCommandPool;
 
 		VkDescriptorPool m_ImGuiDescriptorPool;
+		Scope<VulkanTextureTable> m_TextureTable;
+		Scope<VulkanUploadManager> m_UploadManager;
+		Scope<VulkanUniformRing> m_UniformRing;
 		
 		VmaAllocator m_Allocator;
 		VkExtent2D m_DrawExtent;
@@ -120,6 +187,9 @@ namespace Echo
 		ShaderLibrary m_ShaderLibrary;
 		uint32_t m_CurrentFrame = 0;
 
+		// Guards the frames' retired lists, textures may be destroyed off the main thread
+		std::mutex m_RetireMutex;
+
 		std::vector<VulkanFramebuffer*> m_Framebuffers;
 		std::vector<VulkanFramebuffer*> m_ImGuiFramebuffers;
 		std::vector<VulkanTexture2D*> m_ImGuiTextures;
@@ -42,7 +42,7 @@ namespace Echo
 		EC_PROFILE_FUNCTION();
 		if (GetCurrentLayout(index) != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
 		{
-			m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+			m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 			{
 				TransitionImageLayout(cmd, index, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 			});
@@ -77,7 +77,7 @@ namespace Echo
 
 			CreateImage(i, width, height);
 
-			m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+			m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 			{
 				VulkanImages::TransitionImage(cmd, m_Framebuffers[i].Image, VK_IMAGE_LAYOUT_UNDEFINED, GetCurrentLayout(i));
 			});
@@ -114,7 +114,7 @@ namespace Echo
 		if (!m_UseSamples) return;
 
 		VulkanFramebuffer* framebuffer = (VulkanFramebuffer*)targetFramebuffer;
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+		m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 		{
 			for (uint32_t i = 0; i < m_ColorFormats.size(); i++)
 			{
@@ -167,8 +167,8 @@ namespace Echo
 				m_DescriptorSet = nullptr;
 			}
 
-			vkDestroySampler(m_Device->GetDevice(), framebuffer.Sampler, nullptr);
-			m_Device->DestroyImage(framebuffer);
+			m_Device->RetireSampler(framebuffer.Sampler);
+			m_Device->RetireImage(framebuffer);
 
 			framebuffer.Destroyed = true;
 		}
@@ -306,8 +306,9 @@ namespace Echo
 
 		m_Framebuffers[index] = image;
 
-		m_Device->DestroyImage(oldImage);
-		m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+		// Frames still in flight may be drawing to or sampling the old image
+		m_Device->RetireImage(oldImage);
+		m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 		{
 			VulkanImages::TransitionImage(cmd, m_Framebuffers[index].Image, VK_IMAGE_LAYOUT_UNDEFINED, m_Framebuffers[index].ImageLayout);
 		});
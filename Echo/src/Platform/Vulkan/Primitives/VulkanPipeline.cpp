@@ -6,6 +6,7 @@
 #include "VulkanBuffer.h"
 #include "Vulkan/VulkanRenderCaps.h"
 #include "VulkanShader.h"
+#include "Vulkan/Utils/VulkanTextureTable.h"
 
 #include <unordered_set>
 
@@ -25,6 +26,11 @@ namespace Echo
 			case ShaderDataType::Int3:      return VK_FORMAT_R32G32B32_SINT;
 			case ShaderDataType::Int4:      return VK_FORMAT_R32G32B32A32_SINT;
 			case ShaderDataType::Bool:      return VK_FORMAT_R8_UINT;
+			case ShaderDataType::UByte4Norm:  return VK_FORMAT_R8G8B8A8_UNORM;
+			case ShaderDataType::UShort2Norm: return VK_FORMAT_R16G16_UNORM;
+			case ShaderDataType::UShort:      return VK_FORMAT_R16_UINT;
+			case ShaderDataType::UByte:       return VK_FORMAT_R8_UINT;
+			case ShaderDataType::Half:        return VK_FORMAT_R16_SFLOAT;
 			default: return VK_FORMAT_UNDEFINED;
 		}
 	}
@@ -52,45 +58,57 @@ namespace Echo
 	void VulkanPipeline::Bind(CommandBuffer* cmd)
 	{
 		EC_PROFILE_FUNCTION();
-		VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)cmd)->GetCommandBuffer();
+		PrepareBind();
+		RecordBind(((VulkanCommandBuffer*)cmd)->GetCommandBuffer());
+	}
 
-		if (m_PipelineType == PipelineType::Graphics)
+	void VulkanPipeline::PrepareBind()
+	{
+		m_DynamicOffsets.clear();
+		for (auto& setUniforms : m_DynamicUniforms)
 		{
-			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
-			if (HasDescriptorSet())
+			for (auto& uniform : setUniforms)
 			{
-				for (uint32_t i = 0; i < m_DescriptorSets.size(); i++)
-				{
-					vkCmdBindDescriptorSets(
-						commandBuffer,
-						VK_PIPELINE_BIND_POINT_GRAPHICS,
-						m_PipelineLayout,
-						i,  // Set index
-						1,  // Set count
-						&m_DescriptorSets[i],
-						0, nullptr
-					);
-				}
+				m_DynamicOffsets.push_back(uniform.Buffer ? ((VulkanUniformBuffer*)uniform.Buffer.get())->GetOffset() : 0);
 			}
 		}
+	}
+
+	void VulkanPipeline::RecordBind(VkCommandBuffer commandBuffer)
+	{
+		if (m_PipelineType == PipelineType::Graphics)
+		{
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+			BindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+		}
 		else if (m_PipelineType == PipelineType::Graphics)
 		{
 			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
-			if (HasDescriptorSet())
-			{
-				for (uint32_t i = 0; i < m_DescriptorSets.size(); i++)
-				{
-					vkCmdBindDescriptorSets(
-						commandBuffer,
-						VK_PIPELINE_BIND_POINT_GRAPHICS,
-						m_PipelineLayout,
-						i,  // Set index
-						1,  // Set count
-						&m_DescriptorSets[i],
-						0, nullptr
-					);
-				}
-			}
+			BindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+		}
+	}
+
+	void VulkanPipeline::BindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint)
+	{
+		if (!HasDescriptorSet())
+			return;
+
+		uint32_t firstOffset = 0;
+		for (uint32_t i = 0; i < m_DescriptorSets.size(); i++)
+		{
+			uint32_t offsetCount = (uint32_t)m_DynamicUniforms[i].size();
+			EC_CORE_ASSERT(firstOffset + offsetCount <= m_DynamicOffsets.size(), "Pipeline bound without PrepareBind!");
+
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				bindPoint,
+				m_PipelineLayout,
+				i,  // Set index
+				1,  // Set count
+				&m_DescriptorSets[i],
+				offsetCount, m_DynamicOffsets.data() + firstOffset
+			);
+			firstOffset += offsetCount;
 		}
 	}
 
@@ -121,7 +139,7 @@ namespace Echo
 
 		if (fb->GetCurrentLayout(index) != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
 		{
-			m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+			m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 			{
 				fb->TransitionImageLayout(cmd, index, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 			});
@@ -157,9 +175,23 @@ namespace Echo
 
 		VulkanUniformBuffer* ubo = (VulkanUniformBuffer*)uniformBuffer.get();
 
-		DescriptorWriter writer;
-		writer.WriteBuffer(binding, ubo->GetBuffer().Buffer, ubo->GetSize(), 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-		writer.UpdateSet(m_Device->GetDevice(), m_DescriptorSets[set]);
+		for (auto& uniform : m_DynamicUniforms[set])
+		{
+			if (uniform.Binding != binding)
+				continue;
+
+			// Frames in flight may still read the set, so it is only written when it has to change
+			if (uniform.Range != ubo->GetSize())
+			{
+				DescriptorWriter writer;
+				writer.WriteBuffer(binding, ubo->GetBuffer(), ubo->GetSize(), 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+				writer.UpdateSet(m_Device->GetDevice(), m_DescriptorSets[set]);
+				uniform.Range = ubo->GetSize();
+			}
+
+			uniform.Buffer = uniformBuffer;
+			return;
+		}
 	}
 
 	void VulkanPipeline::BindResource(uint32_t binding, uint32_t set, Texture2D* texture)
@@ -189,7 +221,7 @@ namespace Echo
 
 		if (fb->GetCurrentLayout(index) != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
 		{
-			m_Device->ImmediateSubmit([&](VkCommandBuffer cmd)
+			m_Device->FrameSubmit([&](VkCommandBuffer cmd)
 			{
 				fb->TransitionImageLayout(cmd, index, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 			});
@@ -276,6 +308,11 @@ namespace Echo
 				case VertexFormat::Int2:   return VK_FORMAT_R32G32_SINT;
 				case VertexFormat::Int3:   return VK_FORMAT_R32G32B32_SINT;
 				case VertexFormat::Int4:   return VK_FORMAT_R32G32B32A32_SINT;
+				case VertexFormat::UByte4Norm:  return VK_FORMAT_R8G8B8A8_UNORM;
+				case VertexFormat::UShort2Norm: return VK_FORMAT_R16G16_UNORM;
+				case VertexFormat::UShort:      return VK_FORMAT_R16_UINT;
+				case VertexFormat::UByte:       return VK_FORMAT_R8_UINT;
+				case VertexFormat::Half:        return VK_FORMAT_R16_SFLOAT;
 				default: throw std::runtime_error("Unknown vertex attribute format.");
 			}
 		};
@@ -286,7 +323,7 @@ namespace Echo
 			VkVertexInputBindingDescription bindingDescription{};
 			bindingDescription.binding = 0;
 			bindingDescription.stride = layout.GetStride();
-			bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+			bindingDescription.inputRate = spec.InputRate == VertexInputRate::Instance ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
 
 			bindingDescriptions.push_back(bindingDescription);
 
@@ -463,7 +500,7 @@ namespace Echo
 			switch (type)
 			{
 				case DescriptorType::UniformBuffer:
-					return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+					return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 				case DescriptorType::StorageBuffer:
 					return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 				case DescriptorType::SampledImage:
@@ -504,6 +541,14 @@ namespace Echo
 
 		for (const auto& [setIndex, layouts] : setLayouts)
 		{
+			// Shared with every other pipeline and owned by the device
+			if (setIndex == VulkanTextureTable::TextureSet)
+			{
+				vkSetLayouts.push_back(m_Device->GetTextureTable()->GetLayout());
+				m_DescriptorSetLayouts.push_back(VK_NULL_HANDLE);
+				continue;
+			}
+
 			DescriptorLayoutBuilder builder;
 
 			for (const auto& layout : layouts)
@@ -560,6 +605,7 @@ namespace Echo
 		}
 		m_DescriptorSets.clear();
 		m_DescriptorAllocators.clear();
+		m_DynamicUniforms.clear();
 
 		std::map<uint32_t, std::vector<DescriptionSetLayout>> setLayoutMap;
 		uint32_t maxSetIndex = 0;
@@ -569,7 +615,7 @@ namespace Echo
 			switch (type)
 			{
 				case DescriptorType::UniformBuffer:
-					return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+					return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 				case DescriptorType::StorageBuffer:
 					return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 				case DescriptorType::SampledImage:
@@ -590,10 +636,17 @@ namespace Echo
 		// Prepare vectors with correct size
 		m_DescriptorSets.resize(maxSetIndex + 1);
 		m_DescriptorAllocators.resize(maxSetIndex + 1);
+		m_DynamicUniforms.resize(maxSetIndex + 1);
 
 		// Process each set
 		for (const auto& [setIndex, layouts] : setLayoutMap)
 		{
+			if (setIndex == VulkanTextureTable::TextureSet)
+			{
+				m_DescriptorSets[setIndex] = m_Device->GetTextureTable()->GetDescriptorSet();
+				continue;
+			}
+
 			// Count descriptor types for this set
 			std::unordered_map<VkDescriptorType, uint32_t> descriptorCounts;
 			uint32_t totalDescriptors = 0;
@@ -603,8 +656,17 @@ namespace Echo
 				VkDescriptorType vkType = MapDescriptorType(layout.Type);
 				descriptorCounts[vkType] += layout.Count;
 				totalDescriptors += layout.Count;
+
+				if (vkType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+				{
+					for (uint32_t i = 0; i < layout.Count; i++)
+						m_DynamicUniforms[setIndex].push_back({ layout.Binding });
+				}
 			}
 
+			std::sort(m_DynamicUniforms[setIndex].begin(), m_DynamicUniforms[setIndex].end(),
+					  [](const DynamicUniform& a, const DynamicUniform& b) { return a.Binding < b.Binding; });
+
 			// Setup pool ratios for this set
 			std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> poolSizes;
 			for (auto& [type, count] : descriptorCounts)
@@ -643,6 +705,7 @@ namespace Echo
 		m_DescriptorSetLayouts.clear();
 		m_DescriptorSets.clear();
 		m_DescriptorAllocators.clear();
+		m_DynamicUniforms.clear();
 
 		// Create new resources
 		if (shader->IsCompute())
@@ -16,6 +16,10 @@ namespace Echo
 		virtual ~VulkanPipeline();
 
 		virtual void Bind(CommandBuffer* cmd) override;
+		// Bind split in two. PrepareBind resolves the uniform offsets, which may write the uniform ring,
+		// after that RecordBind only reads the pipeline and can run on any thread
+		void PrepareBind();
+		void RecordBind(VkCommandBuffer commandBuffer);
 
 		virtual PipelineType GetPipelineType() override { return m_PipelineType; }
 
@@ -43,6 +47,16 @@ namespace Echo
 										 std::vector<DescriptorAllocatorGrowable>& oldDescriptorAllocators);
 
 		bool HasDescriptorSet() { return !m_DescriptorSets.empty(); }
+		void BindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint);
+	private:
+		// Uniform buffers are dynamic descriptors into the device's uniform ring. The descriptor is only
+		// written when the range changes, the offset of the bound buffer is read each time the pipeline binds
+		struct DynamicUniform
+		{
+			uint32_t Binding;
+			Ref<UniformBuffer> Buffer;
+			uint32_t Range = 0;
+		};
 	private:
 		VulkanDevice* m_Device;
 		PipelineType m_PipelineType;
@@ -52,6 +66,10 @@ namespace Echo
 		std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
 		std::vector<VkDescriptorSet> m_DescriptorSets;
 		std::vector<DescriptorAllocatorGrowable> m_DescriptorAllocators;
+		// Per set, in binding order, which is the order vkCmdBindDescriptorSets takes the offsets in
+		std::vector<std::vector<DynamicUniform>> m_DynamicUniforms;
+		// Offsets of every set one after the other, as of the last PrepareBind
+		std::vector<uint32_t> m_DynamicOffsets;
 		VkDescriptorPool m_DescriptorPool;
 
 		PipelineSpecification m_PipelineSpecification;
@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 #include <backends/imgui_impl_vulkan.h>
 #include "ImGui/ImGuiTextureRegistry.h"
+#include "Vulkan/Utils/VulkanTextureTable.h"
 
 namespace Echo
 {
@@ -25,12 +26,14 @@ namespace Echo
 		: m_Device((VulkanDevice*)device)
 	{
 		LoadTexture(path, spec);
+		RegisterBindless();
 	}
 
 	VulkanTexture2D::VulkanTexture2D(Device* device, uint32_t width, uint32_t height, void* pixels)
 		: m_Device((VulkanDevice*)device), m_Width(width), m_Height(height)
 	{
 		LoadTexture(pixels, true);
+		RegisterBindless();
 	}
 
 	VulkanTexture2D::VulkanTexture2D(Device* device, const AllocatedImage& allocatedImage)
@@ -40,6 +43,7 @@ namespace Echo
 		m_Height = allocatedImage.ImageExtent.height;
 		m_Channels = 4; // Assume RGBA
 		m_UUID = UUID(); // Generate new UUID
+		RegisterBindless();
 	}
 
 	VulkanTexture2D::~VulkanTexture2D()
@@ -70,8 +74,16 @@ namespace Echo
 			m_DescriptorSet = nullptr;
 		}
 
-		vkDestroySampler(m_Device->GetDevice(), m_Texture.Sampler, nullptr);
-		m_Device->DestroyImage(m_Texture);
+		m_Device->GetTextureTable()->Unregister(m_BindlessIndex);
+		m_BindlessIndex = InvalidBindlessIndex;
+
+		// The copy into the image may not have run yet
+		if (!IsUploaded())
+			m_Device->GetUploadManager()->Wait(m_Upload);
+
+		// The bindless slot is only reused once frames in flight are done with it, the same goes for what it points at
+		m_Device->RetireSampler(m_Texture.Sampler);
+		m_Device->RetireImage(m_Texture);
 
 		m_IsDestroyed = true;
 	}
@@ -100,7 +112,7 @@ namespace Echo
 					pixels[y * 16 + x] = ((x % 2) ^ (y % 2)) ? magenta : black;
 				}
 			}
-			LoadTexture(pixels.data());
+			LoadTexture(pixels.data(), true);
 			return;
 		}
 		else
@@ -109,7 +121,7 @@ namespace Echo
 			m_Height = height;
 			m_Channels = channels;
 
-			m_Texture = m_Device->CreateImageTex(data, { m_Width, m_Height, 1 }, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT);
+			m_Texture = m_Device->CreateImageTex(data, { m_Width, m_Height, 1 }, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, false, &m_Upload);
 		}
 		stbi_image_free(data);
 
@@ -121,10 +133,19 @@ namespace Echo
 		vkCreateSampler(m_Device->GetDevice(), &sampl, nullptr, &m_Texture.Sampler);
 	}
 
+	void VulkanTexture2D::RegisterBindless()
+	{
+		// Images without a sampler (raw attachments) are bound the regular way
+		if (m_Texture.Sampler == VK_NULL_HANDLE)
+			return;
+
+		m_BindlessIndex = m_Device->GetTextureTable()->Register(m_Texture.ImageView, m_Texture.Sampler);
+	}
+
 	void VulkanTexture2D::LoadTexture(void* pixels, bool generateSampler)
 	{
 		EC_PROFILE_FUNCTION();
-		m_Texture = m_Device->CreateImageTex(pixels, { m_Width, m_Height, 1 }, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT);
+		m_Texture = m_Device->CreateImageTex(pixels, { m_Width, m_Height, 1 }, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT, false, &m_Upload);
 		
 		if (generateSampler)
 		{
@@ -24,23 +24,29 @@ namespace Echo
 		virtual void Destroy() override;
 		
 		void* GetImGuiResourceID() override;
+		virtual uint32_t GetBindlessIndex() override { return m_BindlessIndex; }
 
 		VkSampler GetSampler() { return m_Texture.Sampler; }
 		AllocatedImage GetTexture() { return m_Texture; }
+		// The pixels reach the image asynchronously, frames drawn before that wait for them on the GPU
+		bool IsUploaded() { return m_Device->GetUploadManager()->IsComplete(m_Upload); }
 
 		virtual bool operator==(const Texture& other) const override { return m_UUID == ((VulkanTexture2D&)other).m_UUID; }
 
 	private:
 		void LoadTexture(const std::filesystem::path& path, const Texture2DSpecification& spec);
 		void LoadTexture(void* pixels, bool generateSampler = false);
+		void RegisterBindless();
 	private:
 		VulkanDevice* m_Device;
 		AllocatedImage m_Texture;
+		UploadToken m_Upload;
 
 		UUID m_UUID;
 		int m_ImGuiID = -1;
 
 		VkDescriptorSet m_DescriptorSet = nullptr;
+		uint32_t m_BindlessIndex = InvalidBindlessIndex;
 
 		uint32_t m_Width, m_Height, m_Channels;
 		bool m_IsError = false;
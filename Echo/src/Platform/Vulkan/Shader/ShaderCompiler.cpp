@@ -37,6 +37,11 @@ namespace Echo
 			case ShaderDataType::Mat3:   return "Mat3";
 			case ShaderDataType::Mat4:   return "Mat4";
 			case ShaderDataType::Bool:   return "Bool";
+			case ShaderDataType::UByte4Norm:  return "UByte4Norm";
+			case ShaderDataType::UShort2Norm: return "UShort2Norm";
+			case ShaderDataType::UShort:      return "UShort";
+			case ShaderDataType::UByte:       return "UByte";
+			case ShaderDataType::Half:        return "Half";
 			default:                     return "Unknown";
 		}
 	}
@@ -351,6 +356,31 @@ namespace Echo
 						const char* fieldName = field->getName();
 						ShaderDataType fieldType = SlangTypeToShaderDataType(field->getType());
 
+						// [VertexFormat("UByte4Norm")] and friends store the attribute packed,
+						// the input assembler expands it back to the declared shader type
+						for (uint32_t attributeIndex = 0; attributeIndex < field->getUserAttributeCount(); attributeIndex++)
+						{
+							auto attribute = field->getUserAttributeByIndex(attributeIndex);
+							if (std::strcmp(attribute->getName(), "VertexFormat") != 0)
+								continue;
+
+							size_t formatLength = 0;
+							const char* format = attribute->getArgumentValueString(0, &formatLength);
+							std::string formatName = format ? std::string(format, formatLength) : std::string();
+							// Some Slang versions hand back the literal with its quotes
+							if (formatName.size() >= 2 && formatName.front() == '"' && formatName.back() == '"')
+								formatName = formatName.substr(1, formatName.size() - 2);
+
+							ShaderDataType packedType = ShaderDataTypeFromString(formatName);
+							if (packedType == ShaderDataType::None)
+							{
+								EC_CORE_WARN("Unknown vertex format on attribute {0}", fieldName);
+								continue;
+							}
+
+							fieldType = packedType;
+						}
+
 						layout.AddElement({ fieldType, fieldName });
 
 						EC_CORE_INFO("    - {0}: {1}", fieldName, ShaderDataTypeToString(fieldType))
@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "VulkanTextureTable.h"
+
+#include "VulkanDescriptors.h"
+#include "Vulkan/Primitives/VulkanDevice.h"
+
+namespace Echo 
+{
+
+	VulkanTextureTable::VulkanTextureTable(VulkanDevice* device, uint32_t capacity)
+		: m_Device(device), m_Capacity(capacity)
+	{
+		EC_PROFILE_FUNCTION();
+		// Unused slots stay unwritten, and slots no frame in flight samples can be written while the set is bound
+		VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = { .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO };
+		bindingFlagsInfo.bindingCount = 1;
+		bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+		DescriptorLayoutBuilder builder;
+		builder.AddBinding(0, m_Capacity, VK_SHADER_STAGE_ALL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+		m_Layout = builder.Build(m_Device->GetDevice(), &bindingFlagsInfo, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+		VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_Capacity };
+
+		VkDescriptorPoolCreateInfo poolInfo = { .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		if (vkCreateDescriptorPool(m_Device->GetDevice(), &poolInfo, nullptr, &m_Pool) != VK_SUCCESS)
+		{
+			EC_CORE_CRITICAL("Failed to create texture table descriptor pool!");
+		}
+
+		VkDescriptorSetAllocateInfo allocInfo = { .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+		allocInfo.descriptorPool = m_Pool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_Layout;
+
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &m_DescriptorSet) != VK_SUCCESS)
+		{
+			EC_CORE_CRITICAL("Failed to allocate texture table descriptor set!");
+		}
+	}
+
+	VulkanTextureTable::~VulkanTextureTable()
+	{
+		vkDestroyDescriptorPool(m_Device->GetDevice(), m_Pool, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device->GetDevice(), m_Layout, nullptr);
+	}
+
+	uint32_t VulkanTextureTable::Register(VkImageView imageView, VkSampler sampler)
+	{
+		EC_PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint32_t frameCount = m_Device->GetFrameCount();
+		for (size_t i = 0; i < m_PendingFrees.size();)
+		{
+			// Once the frame count moved past a full ring, the frame that released it has been waited on
+			if (frameCount - m_PendingFrees[i].FrameCount > VulkanDevice::MAX_FRAMES_IN_FLIGHT)
+			{
+				m_FreeIndices.push_back(m_PendingFrees[i].Index);
+				m_PendingFrees[i] = m_PendingFrees.back();
+				m_PendingFrees.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		uint32_t index;
+		if (!m_FreeIndices.empty())
+		{
+			index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
+		}
+		else if (m_NextIndex < m_Capacity)
+		{
+			index = m_NextIndex++;
+		}
+		else
+		{
+			EC_CORE_ERROR("Texture table is full ({0} textures)!", m_Capacity);
+			return InvalidIndex;
+		}
+
+		DescriptorWriter writer;
+		writer.WriteImage(index, 0, imageView, sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+		writer.UpdateSet(m_Device->GetDevice(), m_DescriptorSet);
+
+		return index;
+	}
+
+	void VulkanTextureTable::Unregister(uint32_t index)
+	{
+		if (index == InvalidIndex)
+			return;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingFrees.push_back({ index, m_Device->GetFrameCount() });
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <mutex>
+
+namespace Echo 
+{
+
+	class VulkanDevice;
+
+	// One descriptor set with a large combined image sampler array, shared by every pipeline that declares
+	// set TextureSet. A texture writes its descriptor once when it is created and keeps the index for its
+	// lifetime, so shaders index the array directly and batches never rebind textures.
+	class VulkanTextureTable
+	{
+	public:
+		static constexpr uint32_t TextureSet = 1;
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		VulkanTextureTable(VulkanDevice* device, uint32_t capacity);
+		~VulkanTextureTable();
+
+		uint32_t Register(VkImageView imageView, VkSampler sampler);
+		// The index is only handed out again once no frame in flight can still sample it
+		void Unregister(uint32_t index);
+
+		VkDescriptorSetLayout GetLayout() { return m_Layout; }
+		VkDescriptorSet GetDescriptorSet() { return m_DescriptorSet; }
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+	private:
+		struct PendingFree
+		{
+			uint32_t Index;
+			uint32_t FrameCount;
+		};
+	private:
+		VulkanDevice* m_Device;
+
+		VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
+		VkDescriptorPool m_Pool = VK_NULL_HANDLE;
+		VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
+
+		uint32_t m_Capacity;
+		uint32_t m_NextIndex = 0;
+		std::vector<uint32_t> m_FreeIndices;
+		std::vector<PendingFree> m_PendingFrees;
+
+		std::mutex m_Mutex;
+	};
+
+}
\ No newline at end of file
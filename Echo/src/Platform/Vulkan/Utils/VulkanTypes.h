@@ -16,7 +16,7 @@ namespace Echo
 		VkImageLayout ImageLayout;
 
 		VkSampleCountFlagBits Samples;
-		VkSampler Sampler;
+		VkSampler Sampler = VK_NULL_HANDLE;
 		bool DepthTexture = false;
 		bool Destroyed = false;
 	};
@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "VulkanUniformRing.h"
+
+#include "Vulkan/Primitives/VulkanDevice.h"
+#include "Vulkan/VulkanRenderCaps.h"
+
+namespace Echo
+{
+
+	VulkanUniformRing::VulkanUniformRing(VulkanDevice* device, uint32_t frameSize)
+		: m_Device(device)
+	{
+		EC_PROFILE_FUNCTION();
+		m_Alignment = std::max(VulkanRenderCaps::GetMinUniformBufferOffsetAlignment(), 16u);
+		m_FrameSize = (frameSize + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+		// Coherent so CPU writes never need an explicit flush
+		m_Buffer = m_Device->CreateBuffer((size_t)m_FrameSize * Device::MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU,
+										  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		m_MappedData = (uint8_t*)m_Device->GetMappedData(m_Buffer);
+	}
+
+	VulkanUniformRing::~VulkanUniformRing()
+	{
+		m_Device->DestroyBuffer(m_Buffer);
+	}
+
+	uint32_t VulkanUniformRing::Allocate(uint32_t size, void** mappedData)
+	{
+		if (m_FrameCount != m_Device->GetFrameCount())
+		{
+			// First use since this frame slot was last in flight, the whole segment is free again
+			m_FrameCount = m_Device->GetFrameCount();
+			m_Cursor = 0;
+		}
+
+		uint32_t alignedSize = (size + m_Alignment - 1) / m_Alignment * m_Alignment;
+		// Descriptors are written once against the one buffer, so the ring can't grow. Wrapping would overwrite
+		// uniforms the frame's earlier draws still read, a frame that needs more is an error in every build
+		if ((uint64_t)m_Cursor + alignedSize > m_FrameSize)
+		{
+			EC_CORE_CRITICAL("Uniform ring frame segment is full ({0} of {1} bytes used, {2} requested)!", m_Cursor, m_FrameSize, alignedSize);
+			throw std::runtime_error("Uniform ring frame segment is full");
+		}
+
+		uint32_t offset = m_Device->GetFrameIndex() * m_FrameSize + m_Cursor;
+		m_Cursor += alignedSize;
+
+		*mappedData = m_MappedData + offset;
+		return offset;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "VulkanTypes.h"
+
+namespace Echo
+{
+
+	class VulkanDevice;
+
+	// Storage behind every uniform buffer. One persistently mapped buffer with a segment per frame in flight,
+	// each handed out linearly and reset the first time its frame slot comes around again. Descriptors point
+	// at the whole buffer and pipelines pass the block to read as a dynamic offset when they bind
+	class VulkanUniformRing
+	{
+	public:
+		VulkanUniformRing(VulkanDevice* device, uint32_t frameSize = 1024 * 1024);
+		~VulkanUniformRing();
+
+		// Offset into GetBuffer() of size bytes that the current frame may write through mappedData.
+		// Throws once the frame's segment is used up
+		uint32_t Allocate(uint32_t size, void** mappedData);
+
+		VkBuffer GetBuffer() { return m_Buffer.Buffer; }
+	private:
+		VulkanDevice* m_Device;
+		AllocatedBuffer m_Buffer;
+		uint8_t* m_MappedData;
+
+		uint32_t m_FrameSize;
+		uint32_t m_Alignment;
+
+		uint32_t m_Cursor = 0;
+		uint32_t m_FrameCount = UINT32_MAX;
+	};
+
+}
\ No newline at end of file
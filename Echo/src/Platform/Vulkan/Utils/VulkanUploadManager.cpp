@@ -0,0 +1,358 @@
+#include "pch.h"
+#include "VulkanUploadManager.h"
+
+#include "VulkanInitializers.h"
+#include "Vulkan/Primitives/VulkanDevice.h"
+
+namespace Echo
+{
+
+	static constexpr VkDeviceSize StagingAlignment = 16;
+
+	VulkanUploadManager::VulkanUploadManager(VulkanDevice* device, VkQueue queue, uint32_t queueFamily, uint64_t stagingSize)
+		: m_Device(device), m_Queue(queue), m_QueueFamily(queueFamily), m_StagingSize(stagingSize)
+	{
+		EC_PROFILE_FUNCTION();
+		VkCommandPoolCreateInfo poolCreateInfo = VulkanInitializers::CommandPoolCreateInfo(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, m_QueueFamily);
+		vkCreateCommandPool(m_Device->GetDevice(), &poolCreateInfo, nullptr, &m_CommandPool);
+
+		VkSemaphoreTypeCreateInfo typeCreateInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+		typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeCreateInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = VulkanInitializers::SemaphoreCreateInfo();
+		semaphoreCreateInfo.pNext = &typeCreateInfo;
+		vkCreateSemaphore(m_Device->GetDevice(), &semaphoreCreateInfo, nullptr, &m_Timeline);
+
+		m_Staging = m_Device->CreateBuffer(m_StagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+		m_StagingData = (uint8_t*)m_Device->GetMappedData(m_Staging);
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		EC_PROFILE_FUNCTION();
+		vkQueueWaitIdle(m_Queue);
+
+		for (auto& batch : m_InFlight)
+		{
+			for (auto& buffer : batch.DedicatedStaging)
+				m_Device->DestroyBuffer(buffer);
+		}
+
+		for (auto& buffer : m_Recording.DedicatedStaging)
+			m_Device->DestroyBuffer(buffer);
+
+		m_Device->DestroyBuffer(m_Staging);
+		vkDestroySemaphore(m_Device->GetDevice(), m_Timeline, nullptr);
+		vkDestroyCommandPool(m_Device->GetDevice(), m_CommandPool, nullptr);
+	}
+
+	UploadToken VulkanUploadManager::UploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size)
+	{
+		EC_PROFILE_FUNCTION();
+		if (size == 0)
+			return { m_SubmittedValue };
+
+		VkBuffer staging;
+		VkDeviceSize stagingOffset;
+		uint8_t* stagingData;
+		AllocateStaging(size, staging, stagingOffset, stagingData);
+
+		memcpy(stagingData, data, size);
+
+		VkCommandBuffer cmd = GetRecordingCommandBuffer();
+
+		VkBufferCopy copy{};
+		copy.srcOffset = stagingOffset;
+		copy.dstOffset = offset;
+		copy.size = size;
+		vkCmdCopyBuffer(cmd, staging, buffer, 1, &copy);
+
+		// On the same family the timeline wait alone makes the copy visible to the graphics queue
+		if (IsOwnershipTransfer())
+		{
+			VkBufferMemoryBarrier2 barrier = { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+			barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+			barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+			barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.dstAccessMask = VK_ACCESS_2_NONE;
+			barrier.srcQueueFamilyIndex = m_QueueFamily;
+			barrier.dstQueueFamilyIndex = m_Device->GetGraphicsQueueFamily();
+			barrier.buffer = buffer;
+			barrier.offset = offset;
+			barrier.size = size;
+
+			VkDependencyInfo depInfo = { .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+			depInfo.bufferMemoryBarrierCount = 1;
+			depInfo.pBufferMemoryBarriers = &barrier;
+			vkCmdPipelineBarrier2(cmd, &depInfo);
+
+			barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.srcAccessMask = VK_ACCESS_2_NONE;
+			barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+			m_BufferAcquires.push_back(barrier);
+		}
+
+		return { m_SubmittedValue + 1 };
+	}
+
+	UploadToken VulkanUploadManager::UploadImage(VkImage image, VkExtent3D extent, const void* data, VkDeviceSize size, VkImageLayout finalLayout)
+	{
+		EC_PROFILE_FUNCTION();
+		VkBuffer staging;
+		VkDeviceSize stagingOffset;
+		uint8_t* stagingData;
+		AllocateStaging(size, staging, stagingOffset, stagingData);
+
+		memcpy(stagingData, data, size);
+
+		VkCommandBuffer cmd = GetRecordingCommandBuffer();
+
+		VkImageMemoryBarrier2 barrier = { .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+		barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+		barrier.srcAccessMask = VK_ACCESS_2_NONE;
+		barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = VulkanInitializers::ImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT);
+
+		VkDependencyInfo depInfo = { .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+		depInfo.imageMemoryBarrierCount = 1;
+		depInfo.pImageMemoryBarriers = &barrier;
+		vkCmdPipelineBarrier2(cmd, &depInfo);
+
+		VkBufferImageCopy copyRegion = {};
+		copyRegion.bufferOffset = stagingOffset;
+		copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copyRegion.imageSubresource.mipLevel = 0;
+		copyRegion.imageSubresource.baseArrayLayer = 0;
+		copyRegion.imageSubresource.layerCount = 1;
+		copyRegion.imageExtent = extent;
+		vkCmdCopyBufferToImage(cmd, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+		barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = finalLayout;
+
+		if (IsOwnershipTransfer())
+		{
+			// Release, the layout change happens once, as part of the matching acquire
+			barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.dstAccessMask = VK_ACCESS_2_NONE;
+			barrier.srcQueueFamilyIndex = m_QueueFamily;
+			barrier.dstQueueFamilyIndex = m_Device->GetGraphicsQueueFamily();
+			vkCmdPipelineBarrier2(cmd, &depInfo);
+
+			barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.srcAccessMask = VK_ACCESS_2_NONE;
+			barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+			m_ImageAcquires.push_back(barrier);
+		}
+		else
+		{
+			barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+			vkCmdPipelineBarrier2(cmd, &depInfo);
+		}
+
+		return { m_SubmittedValue + 1 };
+	}
+
+	UploadToken VulkanUploadManager::Flush()
+	{
+		if (m_Recording.CommandBuffer == VK_NULL_HANDLE)
+			return { m_SubmittedValue };
+
+		EC_PROFILE_FUNCTION();
+		vkEndCommandBuffer(m_Recording.CommandBuffer);
+
+		m_Recording.Value = ++m_SubmittedValue;
+		m_Recording.End = m_Head;
+
+		VkCommandBufferSubmitInfo cmdInfo = VulkanInitializers::CommandBufferSubmitInfo(m_Recording.CommandBuffer);
+		VkSemaphoreSubmitInfo signalInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_Timeline);
+		signalInfo.value = m_Recording.Value;
+
+		VkSubmitInfo2 submitInfo = VulkanInitializers::SubmitInfo(&cmdInfo, &signalInfo, nullptr);
+		vkQueueSubmit2(m_Queue, 1, &submitInfo, VK_NULL_HANDLE);
+
+		m_InFlight.push_back(std::move(m_Recording));
+		m_Recording = {};
+
+		return { m_SubmittedValue };
+	}
+
+	bool VulkanUploadManager::IsComplete(UploadToken token)
+	{
+		if (token.Value > m_SubmittedValue)
+			return false;
+
+		uint64_t completed;
+		vkGetSemaphoreCounterValue(m_Device->GetDevice(), m_Timeline, &completed);
+		return completed >= token.Value;
+	}
+
+	void VulkanUploadManager::Wait(UploadToken token)
+	{
+		EC_PROFILE_FUNCTION();
+		if (token.Value > m_SubmittedValue)
+			Flush();
+
+		VkSemaphoreWaitInfo waitInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_Timeline;
+		waitInfo.pValues = &token.Value;
+		vkWaitSemaphores(m_Device->GetDevice(), &waitInfo, UINT64_MAX);
+
+		Reclaim();
+	}
+
+	bool VulkanUploadManager::PrepareGraphicsSubmit(VkSemaphoreSubmitInfo& waitInfo)
+	{
+		Flush();
+
+		if (m_GraphicsWaitedValue == m_SubmittedValue)
+			return false;
+
+		waitInfo = VulkanInitializers::SemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_Timeline);
+		waitInfo.value = m_SubmittedValue;
+		m_GraphicsWaitedValue = m_SubmittedValue;
+
+		return true;
+	}
+
+	void VulkanUploadManager::RecordAcquires(VkCommandBuffer cmd)
+	{
+		EC_PROFILE_FUNCTION();
+		VkDependencyInfo depInfo = { .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+		depInfo.imageMemoryBarrierCount = (uint32_t)m_ImageAcquires.size();
+		depInfo.pImageMemoryBarriers = m_ImageAcquires.data();
+		depInfo.bufferMemoryBarrierCount = (uint32_t)m_BufferAcquires.size();
+		depInfo.pBufferMemoryBarriers = m_BufferAcquires.data();
+		vkCmdPipelineBarrier2(cmd, &depInfo);
+
+		m_ImageAcquires.clear();
+		m_BufferAcquires.clear();
+	}
+
+	VkCommandBuffer VulkanUploadManager::GetRecordingCommandBuffer()
+	{
+		if (m_Recording.CommandBuffer != VK_NULL_HANDLE)
+			return m_Recording.CommandBuffer;
+
+		if (m_FreeCommandBuffers.empty())
+		{
+			VkCommandBuffer cmd;
+			VkCommandBufferAllocateInfo cmdAllocInfo = VulkanInitializers::CommandBufferAllocateInfo(m_CommandPool, 1);
+			vkAllocateCommandBuffers(m_Device->GetDevice(), &cmdAllocInfo, &cmd);
+			m_FreeCommandBuffers.push_back(cmd);
+		}
+
+		m_Recording.CommandBuffer = m_FreeCommandBuffers.back();
+		m_FreeCommandBuffers.pop_back();
+
+		VkCommandBufferBeginInfo beginInfo = VulkanInitializers::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		vkBeginCommandBuffer(m_Recording.CommandBuffer, &beginInfo);
+
+		return m_Recording.CommandBuffer;
+	}
+
+	void VulkanUploadManager::AllocateStaging(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, uint8_t*& mappedData)
+	{
+		VkDeviceSize alignedSize = (size + StagingAlignment - 1) & ~(StagingAlignment - 1);
+		if (alignedSize > m_StagingSize)
+		{
+			AllocatedBuffer dedicated = m_Device->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+			m_Recording.DedicatedStaging.push_back(dedicated);
+
+			buffer = dedicated.Buffer;
+			offset = 0;
+			mappedData = (uint8_t*)m_Device->GetMappedData(dedicated);
+			return;
+		}
+
+		Reclaim();
+		while (!TryAllocateRing(alignedSize, offset))
+		{
+			// The ring is full of copies the GPU hasn't done yet, the only case where an upload waits
+			EC_PROFILE_SCOPE("Wait For Staging Space");
+			Flush();
+			Wait({ m_InFlight.front().Value });
+		}
+
+		buffer = m_Staging.Buffer;
+		mappedData = m_StagingData + offset;
+	}
+
+	bool VulkanUploadManager::TryAllocateRing(VkDeviceSize size, VkDeviceSize& offset)
+	{
+		bool wrapped = m_Head < m_Tail || (m_Head == m_Tail && m_Used > 0);
+		VkDeviceSize padding = 0;
+
+		if (wrapped)
+		{
+			if (m_Tail - m_Head < size)
+				return false;
+		}
+		else if (m_StagingSize - m_Head < size)
+		{
+			// The end of the ring is too small, skip it and start over at the front
+			if (m_Tail < size)
+				return false;
+
+			padding = m_StagingSize - m_Head;
+			m_Head = 0;
+		}
+
+		offset = m_Head;
+		m_Head += size;
+		m_Used += padding + size;
+		m_Recording.Bytes += padding + size;
+
+		return true;
+	}
+
+	void VulkanUploadManager::Reclaim()
+	{
+		if (m_InFlight.empty())
+			return;
+
+		uint64_t completed;
+		vkGetSemaphoreCounterValue(m_Device->GetDevice(), m_Timeline, &completed);
+
+		size_t done = 0;
+		for (; done < m_InFlight.size() && m_InFlight[done].Value <= completed; done++)
+		{
+			Batch& batch = m_InFlight[done];
+			m_Used -= batch.Bytes;
+			m_Tail = batch.End;
+
+			vkResetCommandBuffer(batch.CommandBuffer, 0);
+			m_FreeCommandBuffers.push_back(batch.CommandBuffer);
+
+			for (auto& buffer : batch.DedicatedStaging)
+				m_Device->DestroyBuffer(buffer);
+		}
+
+		m_InFlight.erase(m_InFlight.begin(), m_InFlight.begin() + done);
+
+		if (m_Used == 0)
+		{
+			m_Head = 0;
+			m_Tail = 0;
+		}
+	}
+
+	bool VulkanUploadManager::IsOwnershipTransfer() const
+	{
+		return m_QueueFamily != m_Device->GetGraphicsQueueFamily();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "VulkanTypes.h"
+
+#include <vector>
+
+namespace Echo
+{
+
+	class VulkanDevice;
+
+	// Value the upload timeline semaphore reaches once the copies it was handed out for are done
+	struct UploadToken
+	{
+		uint64_t Value = 0;
+	};
+
+	// Uploads go through one large persistently mapped staging ring and are recorded into a command buffer
+	// of the transfer queue. Nothing waits on the CPU: the recorded copies are submitted as one batch, at the
+	// latest right before the next graphics submission, which waits for them on the GPU through a timeline
+	// semaphore. With a dedicated transfer family the resources are handed over to the graphics family with
+	// release/acquire barriers, so the transfer side doesn't keep what a buffer held outside the written range
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager(VulkanDevice* device, VkQueue queue, uint32_t queueFamily, uint64_t stagingSize = 64 * 1024 * 1024);
+		~VulkanUploadManager();
+
+		// The copy doesn't wait for graphics work, the buffer must not be in use by a frame in flight
+		UploadToken UploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size);
+		// Fills the whole first mip of the image, which is left in finalLayout
+		UploadToken UploadImage(VkImage image, VkExtent3D extent, const void* data, VkDeviceSize size, VkImageLayout finalLayout);
+
+		// Submits everything recorded since the last flush, returns the token of the batch
+		UploadToken Flush();
+
+		bool IsComplete(UploadToken token);
+		void Wait(UploadToken token);
+
+		// Called before every graphics submission. Flushes, then fills the wait on the last batch if the
+		// graphics queue hasn't waited for it yet
+		bool PrepareGraphicsSubmit(VkSemaphoreSubmitInfo& waitInfo);
+		// The acquire half of the ownership transfers, recorded ahead of the submission that waits
+		bool HasPendingAcquires() const { return !m_ImageAcquires.empty() || !m_BufferAcquires.empty(); }
+		void RecordAcquires(VkCommandBuffer cmd);
+	private:
+		struct Batch
+		{
+			VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+			uint64_t Value = 0;
+			// Ring bytes the batch holds, padding included, and where the ring head was when it was submitted
+			uint64_t Bytes = 0;
+			uint64_t End = 0;
+			// Uploads too big for the ring get a staging buffer of their own
+			std::vector<AllocatedBuffer> DedicatedStaging;
+		};
+
+		VkCommandBuffer GetRecordingCommandBuffer();
+		// Returns the staging buffer and offset to write size bytes to
+		void AllocateStaging(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, uint8_t*& mappedData);
+		bool TryAllocateRing(VkDeviceSize size, VkDeviceSize& offset);
+		void Reclaim();
+		bool IsOwnershipTransfer() const;
+	private:
+		VulkanDevice* m_Device;
+		VkQueue m_Queue;
+		uint32_t m_QueueFamily;
+
+		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+		std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+		VkSemaphore m_Timeline = VK_NULL_HANDLE;
+
+		AllocatedBuffer m_Staging;
+		uint8_t* m_StagingData = nullptr;
+		uint64_t m_StagingSize;
+		uint64_t m_Head = 0;
+		uint64_t m_Tail = 0;
+		uint64_t m_Used = 0;
+
+		Batch m_Recording;
+		std::vector<Batch> m_InFlight;
+
+		uint64_t m_SubmittedValue = 0;
+		uint64_t m_GraphicsWaitedValue = 0;
+
+		std::vector<VkImageMemoryBarrier2> m_ImageAcquires;
+		std::vector<VkBufferMemoryBarrier2> m_BufferAcquires;
+	};
+
+}
\ No newline at end of file
@@ -10,6 +10,8 @@ namespace Echo
 	{
 		VkSampleCountFlagBits MaxSampleCount;
 		uint32_t MaxTextureSlots;
+		uint32_t MaxBindlessTextures;
+		uint32_t MinUniformBufferOffsetAlignment;
 	};
 
 	static RenderCaps s_RenderCaps;
@@ -31,6 +33,8 @@ namespace Echo
 		EC_CORE_INFO("Device Abilities:");
 		GetSampleCount(physicalDevice);
 		GetMaxTextureSlots(physicalDevice);
+		GetMaxBindlessTextures(physicalDevice);
+		GetMinUniformBufferOffsetAlignment(physicalDevice);
 	}
 
 	VkSampleCountFlagBits VulkanRenderCaps::GetSampleCount()
@@ -43,6 +47,16 @@ namespace Echo
 		return s_RenderCaps.MaxTextureSlots;
 	}
 
+	uint32_t VulkanRenderCaps::GetMaxBindlessTextures()
+	{
+		return s_RenderCaps.MaxBindlessTextures;
+	}
+
+	uint32_t VulkanRenderCaps::GetMinUniformBufferOffsetAlignment()
+	{
+		return s_RenderCaps.MinUniformBufferOffsetAlignment;
+	}
+
 	void VulkanRenderCaps::GetSampleCount(VkPhysicalDevice physicalDevice)
 	{
 		EC_PROFILE_FUNCTION();
@@ -147,5 +161,34 @@ namespace Echo
 					 s_RenderCaps.MaxTextureSlots, maxSlots);
 	}
 
+	void VulkanRenderCaps::GetMaxBindlessTextures(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceVulkan12Properties properties12{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES };
+		VkPhysicalDeviceProperties2 properties{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+		properties.pNext = &properties12;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+		// The texture table is an update after bind set, which has its own limits
+		uint32_t maxTextures = std::min(properties12.maxPerStageDescriptorUpdateAfterBindSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSamplers);
+		maxTextures = std::min(maxTextures, properties12.maxDescriptorSetUpdateAfterBindSampledImages);
+		maxTextures = std::min(maxTextures, properties12.maxDescriptorSetUpdateAfterBindSamplers);
+
+		// Plenty for any scene, and keeps the descriptor pool small
+		s_RenderCaps.MaxBindlessTextures = std::min(maxTextures, 4096u);
+
+		EC_CORE_INFO("     Max Bindless Textures: {0} (Limited from driver max of {1})",
+					 s_RenderCaps.MaxBindlessTextures, maxTextures);
+	}
+
+	void VulkanRenderCaps::GetMinUniformBufferOffsetAlignment(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		s_RenderCaps.MinUniformBufferOffsetAlignment = (uint32_t)properties.limits.minUniformBufferOffsetAlignment;
+
+		EC_CORE_INFO("     Uniform Buffer Offset Alignment: {0}", s_RenderCaps.MinUniformBufferOffsetAlignment);
+	}
+
 }
 
@@ -12,9 +12,13 @@ namespace Echo
 
 		static VkSampleCountFlagBits GetSampleCount();
 		static uint32_t GetMaxTextureSlots(); 
+		static uint32_t GetMaxBindlessTextures();
+		static uint32_t GetMinUniformBufferOffsetAlignment();
 	private:
 		static void GetSampleCount(VkPhysicalDevice physicalDevice);
 		static void GetMaxTextureSlots(VkPhysicalDevice physicalDevice);
+		static void GetMaxBindlessTextures(VkPhysicalDevice physicalDevice);
+		static void GetMinUniformBufferOffsetAlignment(VkPhysicalDevice physicalDevice);
 	};
 
 }
\ No newline at end of file
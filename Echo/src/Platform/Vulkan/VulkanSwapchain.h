@@ -13,6 +13,7 @@ namespace Echo
 
 		VkExtent2D GetExtent() { return m_Extent; }
 		VkSwapchainKHR GetSwapchain() { return m_Swapchain; }
+		VkFormat GetFormat() { return m_Format; }
 
 		uint32_t AcquireNextImage(VkSemaphore semaphore);
 
@@ -16,6 +16,11 @@
 
 #include <Math/Math.h>
 
+#include <Graphics/NamedRenderer/SpriteKernels.h>
+#include <Core/RadixSort.h>
+#include <Core/JobSystem.h>
+#include <Graphics/Commands/CommandStream.h>
+
 namespace Echo
 {
 
@@ -448,7 +453,7 @@ namespace Echo
 				glm::mat4 cameraView = m_EditorCamera.GetViewMatrix();
 
 				auto& tc = selectedEntity.GetComponent<TransformComponent>();
-				glm::mat4 transform = tc.GetTransform();
+				glm::mat4 transform = m_ActiveScene->GetWorldTransform(selectedEntity);
 
 				bool snap = Input::IsKeyPressed(EC_KEY_LEFT_CONTROL);
 				float snapValue = 0.5f;
@@ -462,6 +467,11 @@ namespace Echo
 
 				if (ImGuizmo::IsUsing())
 				{
+					// The gizmo works in world space, bring the result back into the parent's space
+					Entity parent = selectedEntity.GetParent();
+					if (parent)
+						transform = glm::inverse(m_ActiveScene->GetWorldTransform(parent)) * transform;
+
 					glm::vec3 translation, rotation, scale;
 					Math::DecomposeTransform(transform, translation, rotation, scale);
 
@@ -469,6 +479,7 @@ namespace Echo
 					tc.Translation = translation;
 					tc.Rotation += deltaRot;
 					tc.Scale = scale;
+					selectedEntity.PatchComponent<TransformComponent>();
 				}
 			}
 		}
@@ -518,6 +529,111 @@ namespace Echo
 		ImGui::Text("Circle Count: %d", stats.CircleCount);
 		ImGui::Text("Total Vertices: %d", stats.GetTotalQuadVertexCount() + stats.GetTotalCircleVertexCount());
 		ImGui::Text("Total Indices: %d", stats.GetTotalQuadIndexCount() + stats.GetTotalCircleIndexCount());
+		ImGui::Text("Instanced Quads: %d, Circles: %d", stats.InstancedQuadCount, stats.InstancedCircleCount);
+		ImGui::Text("Upload: %.1f KB vertices, %.1f KB instances", stats.VertexBytes / 1024.0f, stats.InstanceBytes / 1024.0f);
+		ImGui::Text("Vertex Size: %d B quad, %d B circle", stats.QuadVertexSize, stats.CircleVertexSize);
+		ImGui::Text("Retained Quads: %d (%.1f KB patched)", stats.RetainedQuadCount, stats.RetainedBytes / 1024.0f);
+		ImGui::Text("Sorted Submissions: %d", stats.SortedCount);
+		ImGui::Text("Frustum Culling: %d visible, %d culled", stats.VisibleCount, stats.CulledCount);
+
+		bool instancing = Renderer2D::IsInstancingEnabled();
+		if (ImGui::Checkbox("Instanced Quads/Circles", &instancing))
+		{
+			Renderer2D::SetInstancingEnabled(instancing);
+		}
+
+		bool sorting = Renderer2D::IsSortingEnabled();
+		if (ImGui::Checkbox("Sorted Submission", &sorting))
+		{
+			Renderer2D::SetSortingEnabled(sorting);
+		}
+
+		bool culling = Renderer2D::IsCullingEnabled();
+		if (ImGui::Checkbox("Frustum Culling", &culling))
+		{
+			Renderer2D::SetCullingEnabled(culling);
+		}
+
+		bool parallelRecording = CommandList::IsParallelRecordingEnabled();
+		if (ImGui::Checkbox("Parallel Command Recording", &parallelRecording))
+		{
+			CommandList::SetParallelRecordingEnabled(parallelRecording);
+		}
+
+		if (ImGui::Button("Benchmark Job System (100k jobs)"))
+		{
+			m_JobSystemBenchmark = JobSystem::Benchmark(100000);
+		}
+		if (m_JobSystemBenchmark.JobCount > 0)
+		{
+			ImGui::Text("  %s: %u failures, %.2f ms", m_JobSystemBenchmark.Passed() ? "Passed" : "FAILED", m_JobSystemBenchmark.Failures, m_JobSystemBenchmark.Milliseconds);
+		}
+
+		if (ImGui::Button("Benchmark Radix Sort (1M keys)"))
+		{
+			m_RadixSortBenchmark[0] = RadixSort::Benchmark(1000000, false);
+			m_RadixSortBenchmark[1] = RadixSort::Benchmark(1000000, true);
+		}
+		if (m_RadixSortBenchmark[0] > 0.0)
+		{
+			ImGui::Text("  Single thread: %.2f ms, job system: %.2f ms", m_RadixSortBenchmark[0], m_RadixSortBenchmark[1]);
+		}
+
+		if (ImGui::Button("Benchmark Command Stream (100k commands)"))
+		{
+			m_CommandStreamBenchmark = CommandStream::Benchmark(100000);
+		}
+		if (m_CommandStreamBenchmark > 0.0)
+		{
+			ImGui::Text("  Record and replay: %.2f ms", m_CommandStreamBenchmark);
+		}
+
+		if (ImGui::Button("Benchmark Scene Save/Copy (25k, 50k entities)"))
+		{
+			m_SceneSaveBenchmark[0] = SceneSerializer::Benchmark(25000);
+			m_SceneSaveBenchmark[1] = SceneSerializer::Benchmark(50000);
+			m_SceneCopyBenchmark[0] = Scene::BenchmarkCopy(25000);
+			m_SceneCopyBenchmark[1] = Scene::BenchmarkCopy(50000);
+		}
+		if (m_SceneSaveBenchmark[0] > 0.0)
+		{
+			ImGui::Text("  Save: %.2f ms, %.2f ms", m_SceneSaveBenchmark[0], m_SceneSaveBenchmark[1]);
+			ImGui::Text("  Copy: %.2f ms, %.2f ms", m_SceneCopyBenchmark[0], m_SceneCopyBenchmark[1]);
+		}
+
+		if (ImGui::Button("Benchmark Scene Copy (100k entities)"))
+		{
+			m_SceneCopy100kBenchmark[0] = Scene::BenchmarkCopy(100000, false);
+			m_SceneCopy100kBenchmark[1] = Scene::BenchmarkCopy(100000, true);
+		}
+		if (m_SceneCopy100kBenchmark[0] > 0.0)
+		{
+			ImGui::Text("  Per entity: %.2f ms, bulk clone: %.2f ms", m_SceneCopy100kBenchmark[0], m_SceneCopy100kBenchmark[1]);
+		}
+
+		if (ImGui::Button("Stress Test Renderer2D Batches (1.1M quads)"))
+		{
+			m_BatchStressResult = Renderer2D::StressTestBatches(1100000);
+		}
+		if (m_BatchStressResult.BatchCount > 0)
+		{
+			ImGui::Text("  %s: %u batches, %u failed, %.2f ms", m_BatchStressResult.Passed() ? "Passed" : "Failed",
+				m_BatchStressResult.BatchCount, m_BatchStressResult.FailedBatches, m_BatchStressResult.Milliseconds);
+		}
+
+		ImGui::Text("Sprite Kernels: %s", CPUInfo::SIMDLevelToString(Renderer2D::GetSIMDLevel()));
+		if (ImGui::Button("Benchmark Sprite Kernels"))
+		{
+			for (uint8_t level = 0; level <= (uint8_t)CPUInfo::GetSIMDLevel(); level++)
+			{
+				m_SpriteKernelBenchmark[level] = SpriteKernels::Benchmark((SIMDLevel)level);
+			}
+		}
+		for (uint8_t level = 0; level < 3; level++)
+		{
+			if (m_SpriteKernelBenchmark[level] > 0.0)
+				ImGui::Text("  %s: %.0f sprites/ms", CPUInfo::SIMDLevelToString((SIMDLevel)level), m_SpriteKernelBenchmark[level]);
+		}
 
 		// Scene Information
 		ImGui::SeparatorText("Scene Information");
@@ -526,6 +642,10 @@ namespace Echo
 			auto allEntities = m_ActiveScene->GetAllEntitiesWith<TagComponent>();
 			ImGui::Text("Entity Count: %d", (int)allEntities.size());
 			ImGui::Text("Viewport: %dx%d", (int)m_ViewportSize.x, (int)m_ViewportSize.y);
+
+			SceneMemoryReport memory = m_ActiveScene->GetMemoryReport();
+			ImGui::Text("Component Orders: %d (%.1f KB)", memory.ComponentOrderCount, memory.ComponentOrderBytes / 1024.0f);
+			ImGui::Text("As Name Strings (estimate): %.1f KB", memory.EstimatedNameOrderBytes / 1024.0f);
 		}
 
 		// Editor State
@@ -681,7 +801,8 @@ namespace Echo
 	void EditorLayer::OnScenePlay()
 	{
 		EC_PROFILE_FUNCTION();
-		m_ActiveScene = Scene::Copy(m_EditorScene);
+		m_EditorSnapshot = m_EditorScene->CreateSnapshot();
+		m_ActiveScene = m_EditorScene;
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
 		m_ActiveScene->OnRuntimeStart();
@@ -694,6 +815,8 @@ namespace Echo
 		m_ActiveScene->OnRuntimeStop();
 		m_SceneState = SceneState::Edit;
 
+		m_EditorScene->RestoreSnapshot(*m_EditorSnapshot);
+		m_EditorSnapshot = nullptr;
 		m_ActiveScene = m_EditorScene;
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
 	}
@@ -711,7 +834,7 @@ namespace Echo
 			if (primaryCamera.GetHandle() != entt::null)
 			{
 				Camera camera = primaryCamera.GetComponent<CameraComponent>().Camera;
-				Renderer2D::BeginScene(cmd, camera, primaryCamera.GetTransform());
+				Renderer2D::BeginScene(cmd, camera, primaryCamera.GetWorldTransform());
 			}
 		}
 
@@ -59,6 +59,8 @@ namespace Echo
 
 		Ref<Scene> m_ActiveScene;
 		Ref<Scene> m_EditorScene;
+		// Edit state captured on play, the editor scene itself runs the game
+		Ref<SceneSnapshot> m_EditorSnapshot;
 
 		bool m_PrimaryCamera = false;
 		bool m_ShowPhysicsColliders = false; 
@@ -110,6 +112,21 @@ namespace Echo
 		float m_FPSAccumulator = 0.0f;
 		float m_FrameTimeAccumulator = 0.0f;
 		int m_SampleCount = 0;
-	};
-}
 
+		// Sprites per millisecond of each SIMDLevel, 0 until benchmarked
+		double m_SpriteKernelBenchmark[3] = {};
+		// 100k independent jobs, 100k jobs in dependency chains and jobs gated on hand signaled counters
+		JobBenchmarkResult m_JobSystemBenchmark;
+		// Milliseconds for 1M keys, single threaded and on the job system
+		double m_RadixSortBenchmark[2] = {};
+		// Milliseconds to record and decode 100k commands
+		double m_CommandStreamBenchmark = 0.0;
+		// Milliseconds to save and copy scenes of 25k and 50k entities, twice the entities should take about twice as long
+		double m_SceneSaveBenchmark[2] = {};
+		double m_SceneCopyBenchmark[2] = {};
+		// Milliseconds to copy 100k entities one by one and through the bulk storage clone
+		double m_SceneCopy100kBenchmark[2] = {};
+		// Last run of the Renderer2D batch stress test, empty until run
+		BatchStressResult m_BatchStressResult;
+	};
+}
\ No newline at end of file
@@ -40,8 +40,9 @@ namespace Echo
 			const auto& displayOrder = m_Context->GetEntityDisplayOrder();
 			for (const UUID& entityUUID : displayOrder)
 			{
-				Entity entity = m_Context->GetEntityByUUID(entityUUID);
-				if (entity)
+				Entity entity = m_Context->TryGetEntityByUUID(entityUUID);
+				// Children are drawn by their parent node
+				if (entity && !entity.GetParent())
 				{ 
 					DrawEntityNode(entity);
 				}
@@ -62,7 +63,12 @@ namespace Echo
 				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ENTITY_REORDER"))
 				{
 					UUID draggedUUID = *(UUID*)payload->Data;
-					m_Context->ReorderEntity(draggedUUID, displayOrder.size());
+					Entity dragged = m_Context->TryGetEntityByUUID(draggedUUID);
+					if (dragged && dragged.GetParent())
+					{
+						m_Context->SetParent(dragged, {});
+					}
+					m_Context->ReorderEntity(draggedUUID, displayOrder.size() - 1);
 				}
 				ImGui::EndDragDropTarget();
 			}
@@ -83,8 +89,16 @@ namespace Echo
 		EC_PROFILE_FUNCTION();
 		auto& tag = entity.GetComponent<TagComponent>().Tag;
 
+		std::vector<UUID> children;
+		if (entity.HasComponent<RelationshipComponent>())
+		{
+			children = entity.GetComponent<RelationshipComponent>().Children;
+		}
+
 		ImGuiTreeNodeFlags flags = ((m_SelectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0)  | ImGuiTreeNodeFlags_OpenOnArrow;
 		flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
+		if (children.empty())
+			flags |= ImGuiTreeNodeFlags_Leaf;
 		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, tag.c_str());
 
 		if (ImGui::BeginDragDropSource())
@@ -103,8 +117,14 @@ namespace Echo
 				UUID draggedUUID = *(UUID*)payload->Data;
 				UUID targetUUID = entity.GetUUID();
 
+				// Holding Ctrl parents the dragged entity instead of reordering it
+				Entity dragged = m_Context->TryGetEntityByUUID(draggedUUID);
+				if (ImGui::GetIO().KeyCtrl && dragged && draggedUUID != targetUUID)
+				{
+					m_Context->SetParent(dragged, entity);
+				}
 				// Don't reorder if dropping on self
-				if (draggedUUID != targetUUID)
+				else if (draggedUUID != targetUUID)
 				{
 					// Find target index in display order
 					const auto& order = m_Context->GetEntityDisplayOrder();
@@ -127,10 +147,18 @@ namespace Echo
 		bool entityDeleted = false;
 		if (ImGui::BeginPopupContextItem())
 		{
+			if (ImGui::MenuItem("Create Child Entity"))
+			{
+				m_Context->SetParent(m_Context->CreateEntity(), entity);
+			}
 			if (ImGui::MenuItem("Duplicate Entity"))
 			{
 				m_Context->DuplicateEntity(m_SelectionContext);
 			}
+			if (entity.GetParent() && ImGui::MenuItem("Unparent Entity"))
+			{
+				m_Context->SetParent(entity, {});
+			}
 			if (ImGui::MenuItem("Destroy Entity"))
 			{
 				entityDeleted = true;
@@ -145,6 +173,14 @@ namespace Echo
 
 		if (opened)
 		{
+			for (UUID childID : children)
+			{
+				Entity child = m_Context->TryGetEntityByUUID(childID);
+				if (child)
+				{
+					DrawEntityNode(child);
+				}
+			}
 			ImGui::TreePop();
 		}
 